@@ -1,6 +1,36 @@
 #include "PluginEditor.h"
 #include "catch2/benchmark/catch_benchmark_all.hpp"
 #include "catch2/catch_test_macros.hpp"
+#include <thread>
+
+#if JUCE_LINUX
+    #include <unistd.h>
+#elif JUCE_MAC
+    #include <mach/mach.h>
+#endif
+
+// resident memory of the whole process, or 0 where we don't know how to ask
+static size_t residentBytes()
+{
+#if JUCE_LINUX
+    size_t pages = 0, resident = 0;
+    if (auto* statm = std::fopen ("/proc/self/statm", "r"))
+    {
+        if (std::fscanf (statm, "%zu %zu", &pages, &resident) != 2)
+            resident = 0;
+        std::fclose (statm);
+    }
+    return resident * size_t (sysconf (_SC_PAGESIZE));
+#elif JUCE_MAC
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info (mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) &info, &count) != KERN_SUCCESS)
+        return 0;
+    return size_t (info.resident_size);
+#else
+    return 0;
+#endif
+}
 
 TEST_CASE ("Boot performance")
 {
@@ -33,4 +63,422 @@ TEST_CASE ("Boot performance")
             return plugin.getActiveEditor();
         });
     };
+
+    // These two open and paint an editor for a new instance, constructing
+    // the processor too, so they can be compared with each other.
+    BENCHMARK_ADVANCED ("Editor open and first paint, first instance")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        // Nothing else holds the asset cache, so every run starts cold: the
+        // processor brings up a new one and the editor decodes, draws and
+        // lays out everything itself. The knob artwork stays with the knob
+        // look and feel for the whole process, so only the first run pays
+        // for that.
+        meter.measure ([&] (int /* i */) {
+            juce::ImageCache::releaseUnusedImages();
+            PluginProcessor plugin;
+            std::unique_ptr<juce::AudioProcessorEditor> editor (plugin.createEditorIfNeeded());
+            auto snapshot = editor->createComponentSnapshot (editor->getLocalBounds());
+            plugin.editorBeingDeleted (editor.get());
+            return snapshot.getWidth();
+        });
+    };
+
+    BENCHMARK_ADVANCED ("Editor open and first paint, 50th instance")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        // 49 instances that have each shown their editor once, as in a
+        // session where the user has been clicking through tracks
+        std::vector<std::unique_ptr<PluginProcessor>> others;
+        for (int i = 0; i < 49; ++i)
+        {
+            auto& other = others.emplace_back (std::make_unique<PluginProcessor>());
+            std::unique_ptr<juce::AudioProcessorEditor> editor (other->createEditorIfNeeded());
+            editor->createComponentSnapshot (editor->getLocalBounds());
+            other->editorBeingDeleted (editor.get());
+        }
+
+        // images, typeface, text and background are already decoded, laid
+        // out and drawn, so this should cost no more than opening any other
+        // editor, and less than the first instance
+        meter.measure ([&] (int /* i */) {
+            PluginProcessor plugin;
+            std::unique_ptr<juce::AudioProcessorEditor> editor (plugin.createEditorIfNeeded());
+            auto snapshot = editor->createComponentSnapshot (editor->getLocalBounds());
+            plugin.editorBeingDeleted (editor.get());
+            return snapshot.getWidth();
+        });
+    };
+}
+
+TEST_CASE ("Prepare performance")
+{
+    // 5 seconds at 192 kHz, the worst case a delay line has to hold
+    const int maxDelayInSamples = 5 * 192000;
+
+    BENCHMARK_ADVANCED ("DelayLine reset, 5 s at 192 kHz")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        DelayLine delayLine;
+        delayLine.setMaximumDelayInSamples (maxDelayInSamples);
+        delayLine.reset();
+        for (int i = 0; i < maxDelayInSamples; ++i)
+            delayLine.write (0.5f);
+
+        meter.measure ([&] {
+            delayLine.reset();
+            return delayLine.read (1000.0f);
+        });
+    };
+
+    BENCHMARK_ADVANCED ("Processor prepareToPlay at 192 kHz")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        PluginProcessor plugin;
+        meter.measure ([&] { plugin.prepareToPlay (192000.0, 512); });
+    };
+
+    BENCHMARK_ADVANCED ("Project load, 500 instances constructed and prepared")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        // a run takes long enough that Catch only asks for one or two,
+        // so the sessions can be kept and torn down outside the timing
+        std::vector<std::vector<std::unique_ptr<PluginProcessor>>> sessions (size_t (meter.runs()));
+        meter.measure ([&] (int i) {
+            auto& session = sessions[(size_t) i];
+            session.reserve (500);
+            for (int instance = 0; instance < 500; ++instance)
+            {
+                auto& plugin = session.emplace_back (std::make_unique<PluginProcessor>());
+                plugin->prepareToPlay (48000.0, 512);
+            }
+            return session.size();
+        });
+    };
+}
+
+TEST_CASE ("Double precision")
+{
+    // A host that mixes in 64-bit either calls the double processBlock, or,
+    // for a plugin without one, converts every buffer to float and back.
+    const int blockSize = 512;
+    juce::AudioBuffer<double> input (2, blockSize), hostBuffer (2, blockSize);
+    juce::Random random (1);
+    for (int channel = 0; channel < 2; ++channel)
+        for (int sample = 0; sample < blockSize; ++sample)
+            input.setSample (channel, sample, random.nextDouble() * 0.5 - 0.25);
+    juce::MidiBuffer midi;
+
+    BENCHMARK_ADVANCED ("processBlock, native double")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        PluginProcessor plugin;
+        plugin.setProcessingPrecision (juce::AudioProcessor::doublePrecision);
+        plugin.prepareToPlay (48000.0, blockSize);
+        meter.measure ([&] {
+            hostBuffer.makeCopyOf (input, true);
+            plugin.processBlock (hostBuffer, midi);
+            return hostBuffer.getSample (0, 0);
+        });
+    };
+
+    BENCHMARK_ADVANCED ("processBlock, float with the host's conversion round trip")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        PluginProcessor plugin;
+        plugin.prepareToPlay (48000.0, blockSize);
+        juce::AudioBuffer<float> floatBuffer (2, blockSize);
+        meter.measure ([&] {
+            hostBuffer.makeCopyOf (input, true);
+            floatBuffer.makeCopyOf (hostBuffer, true);
+            plugin.processBlock (floatBuffer, midi);
+            hostBuffer.makeCopyOf (floatBuffer, true);
+            return hostBuffer.getSample (0, 0);
+        });
+    };
+}
+
+TEST_CASE ("Kernel dispatch")
+{
+    WARN ("prepareToPlay picks the " << Kernels::select().name << " kernels on this CPU");
+
+    const int numSamples = 4096;
+    std::vector<float> samples (size_t (numSamples), 0.0f);
+    juce::Random random (1234);
+    for (auto& sample : samples)
+        sample = random.nextFloat() * 2.0f - 1.0f;
+
+    std::vector<DelayLine::Storage::Type> stored (size_t (numSamples));
+    DelayLine::Storage::encode (samples.data(), stored.data(), numSamples);
+    std::vector<float> decoded (size_t (numSamples));
+
+    for (auto* kernels : Kernels::getAvailable())
+    {
+        BENCHMARK (std::string ("peakBits, 4096 samples, ") + kernels->name)
+        {
+            return kernels->peakBits (samples.data(), numSamples);
+        };
+
+        BENCHMARK (std::string ("decode, 4096 samples, ") + kernels->name)
+        {
+            kernels->decode (stored.data(), decoded.data(), numSamples);
+            return decoded[0];
+        };
+    }
+}
+
+#if DELAY_TRACING
+TEST_CASE ("Trace export")
+{
+    // A few instances on their own threads, like a host rendering tracks
+    // in parallel, then everything that was recorded goes to a trace file.
+    Trace::clear();
+
+    std::vector<std::unique_ptr<PluginProcessor>> plugins;
+    for (int i = 0; i < 4; ++i)
+    {
+        plugins.push_back (std::make_unique<PluginProcessor>());
+        plugins.back()->prepareToPlay (48000.0, 256);
+    }
+
+    std::vector<std::thread> threads;
+    for (auto& plugin : plugins)
+    {
+        threads.emplace_back ([&plugin] {
+            juce::AudioBuffer<float> buffer (2, 256);
+            juce::MidiBuffer midi;
+            for (int block = 0; block < 2000; ++block)
+            {
+                buffer.clear();
+                buffer.setSample (0, 0, 0.5f);
+                plugin->processBlock (buffer, midi);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    auto file = juce::File::getCurrentWorkingDirectory().getChildFile ("delay_trace.json");
+    REQUIRE (Trace::writeChromeTrace (file));
+    WARN ("Trace written to " << file.getFullPathName());
+}
+#endif
+
+TEST_CASE ("Metering contention")
+{
+    // Four instances side by side, each with some DSP state the audio thread
+    // keeps writing, while a second core polls every instance's level the
+    // way the editors' meters do (flat out here, to make the effect visible).
+    const int numInstances = 4;
+
+    // how the levels used to sit, right next to the DSP state
+    struct Packed
+    {
+        float dspState[6];
+        Measurement levelL, levelR;
+    };
+
+    struct Isolated
+    {
+        float dspState[6];
+        Meters meters;
+    };
+
+    auto runContention = [] (Catch::Benchmark::Chronometer meter, auto& instances, auto getLevel) {
+        std::atomic<bool> running = true;
+        std::thread ui ([&] {
+            while (running.load (std::memory_order_relaxed))
+                for (auto& instance : instances)
+                    getLevel (instance).readAndReset();
+        });
+
+        meter.measure ([&] {
+            for (int block = 0; block < 1000; ++block)
+            {
+                for (auto& instance : instances)
+                {
+                    volatile float* state = instance.dspState;
+                    for (int i = 0; i < 6; ++i)
+                        state[i] = state[i] * 0.5f + 1.0f;
+                }
+            }
+            return instances[0].dspState[0];
+        });
+
+        running = false;
+        ui.join();
+    };
+
+    BENCHMARK_ADVANCED ("1000 blocks of DSP state next to the meters")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<Packed> instances (numInstances);
+        runContention (meter, instances, [] (Packed& p) -> Measurement& { return p.levelL; });
+    };
+
+    BENCHMARK_ADVANCED ("1000 blocks of DSP state, meters on their own cache line")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<Isolated> instances (numInstances);
+        runContention (meter, instances, [] (Isolated& p) -> Measurement& { return p.meters.levelL; });
+    };
+}
+
+TEST_CASE ("Multi-instance scaling")
+{
+    // A host runs every instance once per block, spread over its worker
+    // threads. This does the same on a thread pool with one worker per core,
+    // for growing numbers of instances, to show where shared state or memory
+    // bandwidth stops the work from scaling.
+    const int numCores = juce::SystemStats::getNumCpus();
+    const int blockSize = 256;
+    const double sampleRate = 48000.0;
+    const int numBlocks = 500;  // about 2.7 s of audio per instance
+
+    juce::ThreadPool pool (numCores);
+    double singleInstanceRate = 0.0;
+
+    for (int numInstances : { 1, 2, 4, 8, 16, 32, 64 })
+    {
+        size_t memoryBefore = residentBytes();
+
+        std::vector<std::unique_ptr<PluginProcessor>> plugins;
+        std::vector<juce::AudioBuffer<float>> buffers;
+        for (int i = 0; i < numInstances; ++i)
+        {
+            auto& plugin = plugins.emplace_back (std::make_unique<PluginProcessor>());
+            plugin->prepareToPlay (sampleRate, blockSize);
+            // some feedback, so the delay lines and filters are busy
+            plugin->apvts.getParameter (feedbackParamID.getParamID())->setValueNotifyingHost (0.75f);
+            buffers.emplace_back (2, blockSize);
+        }
+
+        // Each worker takes every numJobs-th instance, so a block costs one
+        // job per worker rather than one per instance.
+        const int numJobs = std::min (numCores, numInstances);
+        auto runBlock = [&] {
+            std::atomic<int> remaining = numJobs;
+            juce::WaitableEvent done;
+            for (int job = 0; job < numJobs; ++job)
+            {
+                pool.addJob ([&, job] {
+                    juce::MidiBuffer midi;
+                    for (int i = job; i < numInstances; i += numJobs)
+                    {
+                        auto& buffer = buffers[(size_t) i];
+                        for (int channel = 0; channel < 2; ++channel)
+                            for (int sample = 0; sample < blockSize; sample += 16)
+                                buffer.setSample (channel, sample, 0.5f);
+                        plugins[(size_t) i]->processBlock (buffer, midi);
+                    }
+                    if (--remaining == 0)
+                        done.signal();
+                });
+            }
+            done.wait();
+            return buffers[0].getSample (0, 0);
+        };
+
+        for (int block = 0; block < 50; ++block)  // warm up, and touch the delay lines
+            runBlock();
+
+        auto start = juce::Time::getHighResolutionTicks();
+        for (int block = 0; block < numBlocks; ++block)
+            runBlock();
+        double seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+
+        // seconds of audio processed per second of wall time, all instances together
+        double audioSeconds = double (numBlocks * blockSize) / sampleRate * double (numInstances);
+        double rate = audioSeconds / seconds;
+        if (numInstances == 1)
+            singleInstanceRate = rate;
+
+        // 100 % means each busy core gets as much done as a lone instance did
+        double efficiency = rate / (singleInstanceRate * double (numJobs)) * 100.0;
+        size_t memoryAfter = std::max (memoryBefore, residentBytes());
+        double memoryPerInstance = double (memoryAfter - memoryBefore) / double (numInstances) / (1024.0 * 1024.0);
+
+        WARN (numInstances << " instances on " << numJobs << " of " << numCores << " cores: "
+                           << juce::String (rate, 1) << "x real time, "
+                           << juce::String (efficiency, 0) << " % per-core efficiency, "
+                           << juce::String (memoryPerInstance, 2) << " MB per instance");
+
+        BENCHMARK (std::to_string (numInstances) + " instances, one block each on the thread pool")
+        {
+            return runBlock();
+        };
+    }
+}
+
+TEST_CASE ("Feedback saturation")
+{
+    // The ADAA saturator against the usual way of keeping a waveshaper from
+    // aliasing: the plain curve run at 4x the rate.
+    const int blockSize = 1024;
+    const int bin = 300;  // a 14 kHz sine at 48 kHz, loud enough to clip hard
+    juce::AudioBuffer<float> input (2, blockSize), buffer (2, blockSize);
+    for (int channel = 0; channel < 2; ++channel)
+        for (int sample = 0; sample < blockSize; ++sample)
+            input.setSample (channel, sample, 3.0f * std::sin (juce::MathConstants<float>::twoPi * float (bin * sample) / float (blockSize)));
+
+    Saturator saturator;
+    auto runSaturator = [&] {
+        buffer.makeCopyOf (input, true);
+        float* left = buffer.getWritePointer (0);
+        float* right = buffer.getWritePointer (1);
+        for (int sample = 0; sample < blockSize; ++sample)
+            saturator.process (left[sample], right[sample]);
+        return buffer.getSample (0, 0);
+    };
+
+    juce::dsp::Oversampling<float> oversampling (2, 2, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true);
+    oversampling.initProcessing (size_t (blockSize));
+    auto runOversampled = [&] {
+        buffer.makeCopyOf (input, true);
+        juce::dsp::AudioBlock<float> block (buffer);
+        auto high = oversampling.processSamplesUp (block);
+        for (size_t channel = 0; channel < high.getNumChannels(); ++channel)
+        {
+            float* data = high.getChannelPointer (channel);
+            for (size_t sample = 0; sample < high.getNumSamples(); ++sample)
+            {
+                float clipped = std::clamp (data[sample], -1.5f, 1.5f);
+                data[sample] = clipped - clipped * clipped * clipped * (4.0f / 27.0f);
+            }
+        }
+        oversampling.processSamplesDown (block);
+        return buffer.getSample (0, 0);
+    };
+
+    // The share of the output that isn't a harmonic of the sine, once the
+    // filters have settled. The sine sits on a bin, so the block is periodic.
+    auto aliasing = [&] (const std::function<float()>& run) {
+        for (int i = 0; i < 8; ++i)
+            run();
+        juce::dsp::FFT fft (10);
+        std::vector<float> spectrum (size_t (2 * blockSize), 0.0f);
+        std::copy (buffer.getReadPointer (0), buffer.getReadPointer (0) + blockSize, spectrum.begin());
+        fft.performFrequencyOnlyForwardTransform (spectrum.data());
+        double total = 0.0, aliased = 0.0;
+        for (int k = 1; k < blockSize / 2; ++k)
+        {
+            double power = double (spectrum[size_t (k)]) * double (spectrum[size_t (k)]);
+            total += power;
+            if (k % bin != 0)
+                aliased += power;
+        }
+        return 10.0 * std::log10 (aliased / total);
+    };
+    WARN ("Aliasing of a clipped 14 kHz sine: ADAA " << juce::String (aliasing (runSaturator), 1)
+                                                      << " dB, 4x oversampled " << juce::String (aliasing (runOversampled), 1) << " dB");
+
+    BENCHMARK ("ADAA saturator, stereo, 1024 samples")
+    {
+        return runSaturator();
+    };
+
+    BENCHMARK ("4x oversampled waveshaper, stereo, 1024 samples")
+    {
+        return runOversampled();
+    };
 }
@@ -0,0 +1,107 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#include "AssetCache.h"
+#include "BinaryData.h"
+
+AssetCache::AssetCache()
+{
+    backgroundThread->addTimeSliceClient(this);
+}
+
+AssetCache::~AssetCache()
+{
+    backgroundThread->removeTimeSliceClient(this);
+}
+
+int AssetCache::useTimeSlice()
+{
+    decodeImages();
+    return -1;  // done, don't call again
+}
+
+void AssetCache::decodeImages()
+{
+    const juce::ScopedLock sl(lock);
+    if (decoded) {
+        return;
+    }
+    noise = juce::ImageCache::getFromMemory(BinaryData::Noise_png, BinaryData::Noise_pngSize);
+    logo = juce::ImageCache::getFromMemory(BinaryData::Logo_png, BinaryData::Logo_pngSize);
+    bypassIcon = juce::ImageCache::getFromMemory(BinaryData::Bypass_png, BinaryData::Bypass_pngSize);
+    decoded = true;
+}
+
+juce::Image AssetCache::getNoise()
+{
+    decodeImages();
+    const juce::ScopedLock sl(lock);
+    return noise;
+}
+
+juce::Image AssetCache::getLogo()
+{
+    decodeImages();
+    const juce::ScopedLock sl(lock);
+    return logo;
+}
+
+juce::Image AssetCache::getBypassIcon()
+{
+    decodeImages();
+    const juce::ScopedLock sl(lock);
+    return bypassIcon;
+}
+
+juce::Image AssetCache::getBackground(int width, int height, float scale,
+                                      const std::function<void(juce::Graphics&)>& draw)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    for (auto& cached : backgrounds) {
+        if (cached.width == width && cached.height == height && cached.scale == scale) {
+            return cached.image;
+        }
+    }
+
+    juce::Image image(juce::Image::RGB,
+                      juce::roundToInt(float(width) * scale),
+                      juce::roundToInt(float(height) * scale), false);
+    {
+        juce::Graphics g(image);
+        g.addTransform(juce::AffineTransform::scale(scale));
+        draw(g);
+    }
+    backgrounds.push_back({ width, height, scale, image });
+    return image;
+}
+
+const AssetCache::CachedText& AssetCache::getStaticText(const juce::String& text, const juce::Font& font)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    for (auto& cached : texts) {
+        if (cached.text == text && cached.font == font) {
+            return cached;
+        }
+    }
+
+    juce::GlyphArrangement glyphs;
+    glyphs.addLineOfText(font, text, 0.0f, font.getAscent());
+    float width = glyphs.getBoundingBox(0, -1, true).getRight();
+    return texts.emplace_back(CachedText { text, font, std::move(glyphs), width });
+}
+
+void AssetCache::drawStaticText(juce::Graphics& g, const juce::String& text, const juce::Font& font,
+                                juce::Rectangle<float> area, juce::Justification justification)
+{
+    const auto& cached = getStaticText(text, font);
+    auto placed = justification.appliedToRectangle(
+        juce::Rectangle<float>(cached.width, font.getHeight()), area);
+    cached.glyphs.draw(g, juce::AffineTransform::translation(placed.getX(), placed.getY()));
+}
+
+float AssetCache::getStaticTextWidth(const juce::String& text, const juce::Font& font)
+{
+    return getStaticText(text, font).width;
+}
@@ -0,0 +1,67 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "BackgroundThread.h"
+#include <deque>
+
+// The editor's images, decoded once per process and shared by every editor.
+// Hold it through a juce::SharedResourcePointer. The first holder (the first
+// plugin instance to load) queues the decoding on the background thread, so
+// by the time an editor opens the images are usually ready. If not, the
+// getters decode on the spot.
+//
+// The static text (knob names and group titles) is laid out here too, the
+// first time it is drawn. The typeface is already created once per process,
+// see Fonts.
+class AssetCache : private juce::TimeSliceClient
+{
+public:
+    AssetCache();
+    ~AssetCache() override;
+
+    juce::Image getNoise();
+    juce::Image getLogo();
+    juce::Image getBypassIcon();
+
+    // The editor background, drawn by draw() the first time it is needed at
+    // this size and display scale. Message thread only.
+    juce::Image getBackground(int width, int height, float scale,
+                              const std::function<void(juce::Graphics&)>& draw);
+
+    // Text that never changes, drawn on one line from glyphs that are laid
+    // out only once. The colour is the one set on g. Message thread only.
+    void drawStaticText(juce::Graphics& g, const juce::String& text, const juce::Font& font,
+                        juce::Rectangle<float> area, juce::Justification justification);
+    float getStaticTextWidth(const juce::String& text, const juce::Font& font);
+
+private:
+    int useTimeSlice() override;
+    void decodeImages();
+
+    juce::CriticalSection lock;
+    bool decoded = false;
+    juce::Image noise, logo, bypassIcon;
+
+    struct CachedBackground
+    {
+        int width, height;
+        float scale;
+        juce::Image image;
+    };
+    std::vector<CachedBackground> backgrounds;
+
+    struct CachedText
+    {
+        juce::String text;
+        juce::Font font;
+        juce::GlyphArrangement glyphs;  // baseline at the font's ascent
+        float width;
+    };
+    const CachedText& getStaticText(const juce::String& text, const juce::Font& font);
+    std::deque<CachedText> texts;  // so the references stay valid
+
+    juce::SharedResourcePointer<BackgroundThread> backgroundThread;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AssetCache)
+};
@@ -0,0 +1,25 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// A low priority worker thread shared by all plugin instances in the process.
+// Hold it through a juce::SharedResourcePointer: the first instance starts
+// it and it is stopped again when the last instance goes away.
+class BackgroundThread : public juce::TimeSliceThread
+{
+public:
+    BackgroundThread() : juce::TimeSliceThread("Delay background thread")
+    {
+        startThread(juce::Thread::Priority::low);
+    }
+
+    ~BackgroundThread() override
+    {
+        stopThread(1000);
+    }
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BackgroundThread)
+};
@@ -5,42 +5,188 @@
 #include "DelayLine.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 
+template <typename SampleType>
+BasicDelayLine<SampleType>::~BasicDelayLine()
+{
+    delete allocated.load();
+    delete copying.load();
+    delete pending.load();
+    delete retired.load();
+}
+
 // reserve enough memory to hold the requested number of samples
-void DelayLine::setMaximumDelayInSamples(int maxLengthInSamples)
+template <typename SampleType>
+void BasicDelayLine<SampleType>::setMaximumDelayInSamples(int maxLengthInSamples)
 {
     jassert (maxLengthInSamples > 0);
     int paddedLength = maxLengthInSamples + 2;
 
+    // the background thread may be copying out of the buffer
+    std::lock_guard lock(allocationLock);
+
     // only allocate memory if the existing buffer is smaller
     // than we need
     if (bufferLength < paddedLength) {
         bufferLength = paddedLength;
         // allocate the memory and store the pointer using
         // buffer.reset()
-        buffer.reset(new float[size_t(bufferLength)]);
+        buffer.reset(new typename Storage::Type[size_t(bufferLength)]);
+        writeIndex = bufferLength - 1;
+        writtenLength = 0;
     }
+
+    // anything the background thread made for the old buffer is stale now
+    delete allocated.exchange(nullptr);
+    delete copying.exchange(nullptr);
+    delete pending.exchange(nullptr);
+    requestedLength.store(0);
+    allocatedLength.store(bufferLength);
 }
 
-// clear out any old data from the delay line
-void DelayLine::reset() noexcept
+// called on the audio thread, only records the request
+template <typename SampleType>
+void BasicDelayLine<SampleType>::requestMaximumDelayInSamples(int maxLengthInSamples) noexcept
 {
-    writeIndex = bufferLength - 1;
-    for (size_t i = 0; i < size_t(bufferLength); ++i){
-        buffer[i] = 0.0f;
+    int paddedLength = maxLengthInSamples + 2;
+    if (paddedLength > bufferLength && paddedLength > requestedLength.load()) {
+        requestedLength.store(paddedLength);
     }
 }
 
-void DelayLine::write(float input) noexcept
+// called on the background thread, frees the buffer that was swapped out,
+// copies the history into a new buffer once the audio thread has said how
+// far it got, and allocates a new one if the audio thread asked for more
+template <typename SampleType>
+void BasicDelayLine<SampleType>::allocateRequestedBuffer()
+{
+    std::lock_guard lock(allocationLock);
+    delete retired.exchange(nullptr);
+
+    if (auto* allocation = copying.exchange(nullptr)) {
+        copyHistory(*allocation);
+        pending.store(allocation);
+        return;
+    }
+
+    int length = requestedLength.load();
+    if (allocated.load() != nullptr || pending.load() != nullptr || length <= allocatedLength.load()) {
+        return;
+    }
+
+    auto* allocation = new Allocation;
+    allocation->data.reset(new typename Storage::Type[size_t(length)]());
+    allocation->length = length;
+    allocatedLength.store(length);
+    allocated.store(allocation);
+}
+
+// called on the audio thread at the start of a block
+template <typename SampleType>
+void BasicDelayLine<SampleType>::swapInRequestedBuffer() noexcept
+{
+    if (auto* allocation = allocated.exchange(nullptr)) {
+        takeSnapshot(*allocation);
+        copying.store(allocation);
+    }
+
+    // the old buffer must have been freed first, so that the audio thread
+    // never has to delete anything itself
+    if (pending.load() == nullptr || retired.load() != nullptr) {
+        return;
+    }
+
+    Allocation* allocation = pending.exchange(nullptr);
+    int64_t numWritten = writeCount - allocation->writeCount;
+    if (numWritten >= int64_t(bufferLength)) {
+        // the ring went all the way round while the history was copied,
+        // so none of it is any good; have it copied again
+        takeSnapshot(*allocation);
+        copying.store(allocation);
+        return;
+    }
+
+    if (allocation->length > bufferLength) {
+        // The copy holds the history up to the snapshot, oldest sample
+        // first. Add what was written since then behind it. Only the newest
+        // writtenLength samples count: anything older was overwritten in
+        // the old ring, maybe while it was being copied, or is from before
+        // a reset.
+        typename Storage::Type* newBuffer = allocation->data.get();
+        int numNew = int(std::min(numWritten, int64_t(writtenLength)));
+        int oldIndex = writeIndex + 1 - numNew;
+        if (oldIndex < 0) {
+            oldIndex += bufferLength;
+        }
+        int newIndex = allocation->writtenLength + int(numWritten) - numNew;
+        for (int i = 0; i < numNew; ++i) {
+            newBuffer[newIndex % allocation->length] = buffer[size_t(oldIndex)];
+            newIndex += 1;
+            oldIndex = oldIndex + 1 == bufferLength ? 0 : oldIndex + 1;
+        }
+        int end = allocation->writtenLength + int(numWritten);
+        writeIndex = end > 0 ? (end - 1) % allocation->length : allocation->length - 1;
+
+        std::swap(buffer, allocation->data);
+        std::swap(bufferLength, allocation->length);
+    }
+    retired.store(allocation);
+}
+
+// called on the audio thread: where the history ends right now
+template <typename SampleType>
+void BasicDelayLine<SampleType>::takeSnapshot(Allocation& allocation) const noexcept
+{
+    allocation.source = buffer.get();
+    allocation.sourceLength = bufferLength;
+    allocation.writeCount = writeCount;
+    allocation.writeIndex = writeIndex;
+    allocation.writtenLength = writtenLength;
+}
+
+// called on the background thread: copies the history that was written up
+// to the snapshot, oldest sample first, so that the newest sample ends up at
+// writtenLength - 1. The audio thread goes on writing meanwhile, but only
+// over the oldest samples, which swapInRequestedBuffer doesn't keep.
+template <typename SampleType>
+void BasicDelayLine<SampleType>::copyHistory(Allocation& allocation) noexcept
+{
+    const typename Storage::Type* source = allocation.source;
+    int startIndex = allocation.writeIndex + 1 - allocation.writtenLength;
+    if (startIndex < 0) {
+        startIndex += allocation.sourceLength;
+    }
+    int firstLength = std::min(allocation.writtenLength, allocation.sourceLength - startIndex);
+    std::copy(source + startIndex, source + startIndex + firstLength, allocation.data.get());
+    std::copy(source, source + allocation.writtenLength - firstLength, allocation.data.get() + firstLength);
+}
+
+// clear out any old data from the delay line. Rather than zeroing the whole
+// buffer, we only forget how much of it was written: reads that reach back
+// further than that return silence.
+template <typename SampleType>
+void BasicDelayLine<SampleType>::reset() noexcept
+{
+    writeIndex = bufferLength - 1;
+    writtenLength = 0;
+}
+
+template <typename SampleType>
+void BasicDelayLine<SampleType>::write(SampleType input) noexcept
 {
     jassert (bufferLength > 0);
     writeIndex +=1;
     if (writeIndex >= bufferLength) {
         writeIndex = 0;
     }
-    buffer[size_t(writeIndex)] = input;
+    buffer[size_t(writeIndex)] = Storage::encode(input);
+    if (writtenLength < bufferLength) {
+        writtenLength += 1;
+    }
+    writeCount += 1;
 }
 
-float DelayLine::read(float delayInSamples) const noexcept
+template <typename SampleType>
+SampleType BasicDelayLine<SampleType>::read(float delayInSamples) const noexcept
 {
     jassert (delayInSamples >= 0.0f);
     jassert (delayInSamples <= bufferLength - 1.0f);
@@ -90,20 +236,57 @@ float DelayLine::read(float delayInSamples) const noexcept
             }
         }
     }
-   float sampleA = buffer[size_t(readIndexA)];
-   float sampleB = buffer[size_t(readIndexB)];
-   float sampleC = buffer[size_t(readIndexC)];
-   float sampleD = buffer[size_t(readIndexD)];
-   float fraction = delayInSamples - float(integerDelay);
-   float slope0 = (sampleC - sampleA)*0.5f;
-   float slope1 = (sampleD - sampleB)*0.5f;
-   float v = sampleB - sampleC;
-   float w = slope0 + v;
-   float a = w + v + slope1;
-   float b = w + a;
-   float stage1 = a * fraction - b;
-   float stage2 = stage1 * fraction + slope0;
+   SampleType sampleA = Storage::decode(buffer[size_t(readIndexA)]);
+   SampleType sampleB = Storage::decode(buffer[size_t(readIndexB)]);
+   SampleType sampleC = Storage::decode(buffer[size_t(readIndexC)]);
+   SampleType sampleD = Storage::decode(buffer[size_t(readIndexD)]);
+   if (integerDelay + 2 >= writtenLength) {
+       // reaching into the part that wasn't written since the last reset
+       sampleA = integerDelay - 1 < writtenLength ? sampleA : SampleType(0);
+       sampleB = integerDelay < writtenLength ? sampleB : SampleType(0);
+       sampleC = integerDelay + 1 < writtenLength ? sampleC : SampleType(0);
+       sampleD = integerDelay + 2 < writtenLength ? sampleD : SampleType(0);
+   }
+   SampleType fraction = SampleType(delayInSamples - float(integerDelay));
+   SampleType slope0 = (sampleC - sampleA)*SampleType(0.5);
+   SampleType slope1 = (sampleD - sampleB)*SampleType(0.5);
+   SampleType v = sampleB - sampleC;
+   SampleType w = slope0 + v;
+   SampleType a = w + v + slope1;
+   SampleType b = w + a;
+   SampleType stage1 = a * fraction - b;
+   SampleType stage2 = stage1 * fraction + slope0;
    return stage2 * fraction + sampleB;
 
 
-}
\ No newline at end of file
+}
+
+// Element n of the regions is what read(delayInSamples) returns right after
+// the n-th write of the coming block, so it must not be consumed before that
+// write. When delayInSamples >= numSamples everything is already in the
+// buffer and the regions can be copied up front.
+template <typename SampleType>
+bool BasicDelayLine<SampleType>::getReadRegions(int delayInSamples, int numSamples, ReadRegions& regions) const noexcept
+{
+    // the first read must not reach back past what was written since the
+    // last reset, as the regions can't fill that part in with zeros
+    if (delayInSamples < 0 || delayInSamples > bufferLength - 1 || numSamples > bufferLength
+        || delayInSamples > writtenLength) {
+        return false;
+    }
+
+    int startIndex = writeIndex + 1 - delayInSamples;
+    if (startIndex < 0) {
+        startIndex += bufferLength;
+    } else if (startIndex >= bufferLength) {
+        startIndex -= bufferLength;
+    }
+
+    size_t firstLength = size_t(std::min(numSamples, bufferLength - startIndex));
+    regions.first = std::span<const typename Storage::Type>(buffer.get() + startIndex, firstLength);
+    regions.second = std::span<const typename Storage::Type>(buffer.get(), size_t(numSamples) - firstLength);
+    return true;
+}
+
+template class BasicDelayLine<float>;
+template class BasicDelayLine<double>;
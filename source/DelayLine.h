@@ -2,23 +2,109 @@
 // Created by Myra Norton on 6/16/25.
 //
 #pragma once
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include "SampleStorage.h"
 
-class DelayLine
+// The format the delay history is kept in, picked per project with the
+// DELAY_LINE_STORAGE CMake option. See SampleStorage.h for the choices.
+#ifndef DELAY_LINE_STORAGE
+    #define DELAY_LINE_STORAGE Float32Storage
+#endif
+
+// Templated on the sample type for the float and double processing paths.
+// The double one always stores doubles.
+template <typename SampleType>
+class BasicDelayLine
 {
     public:
+        using Storage = std::conditional_t<std::is_same_v<SampleType, double>, Float64Storage, DELAY_LINE_STORAGE>;
+        using DecodeFunction = void (*)(const typename Storage::Type*, SampleType*, int) noexcept;
+
+        // The samples that the next block of reads at an integer delay will
+        // return, as at most two contiguous regions of the ring buffer.
+        struct ReadRegions
+        {
+            std::span<const typename Storage::Type> first;
+            std::span<const typename Storage::Type> second;
+
+            SampleType operator[](size_t index) const noexcept
+            {
+                return Storage::decode(index < first.size() ? first[index] : second[index - first.size()]);
+            }
+
+            void copyTo(SampleType* destination, DecodeFunction decode = Storage::decode) const noexcept
+            {
+                decode(first.data(), destination, int(first.size()));
+                decode(second.data(), destination + first.size(), int(second.size()));
+            }
+        };
+
+        ~BasicDelayLine();
+
         void setMaximumDelayInSamples(int maxLengthInSamples);
         void reset() noexcept;
 
-        void write(float input) noexcept;
-        float read(float delayInSamples) const noexcept;
+        // Growing the buffer while the audio is running. The audio thread
+        // asks for a longer delay and the background thread allocates the
+        // memory. At the start of the next block the audio thread notes how
+        // far it has written, the background thread copies the history up
+        // to there, and at the start of a later block the audio thread adds
+        // what it wrote in the meantime and swaps the new buffer in.
+        void requestMaximumDelayInSamples(int maxLengthInSamples) noexcept;
+        void allocateRequestedBuffer();
+        void swapInRequestedBuffer() noexcept;
+
+        void write(SampleType input) noexcept;
+        SampleType read(float delayInSamples) const noexcept;
+        bool getReadRegions(int delayInSamples, int numSamples, ReadRegions& regions) const noexcept;
 
         int getBufferLength() const noexcept
         {
             return bufferLength;
         }
+        int getMaximumDelayInSamples() const noexcept
+        {
+            return bufferLength - 2;
+        }
     private:
-        std::unique_ptr<float[]> buffer;
+        struct Allocation
+        {
+            std::unique_ptr<typename Storage::Type[]> data;
+            int length = 0;
+
+            // where the audio thread was when the history was copied
+            const typename Storage::Type* source = nullptr;
+            int sourceLength = 0;
+            int64_t writeCount = 0;
+            int writeIndex = 0;
+            int writtenLength = 0;
+        };
+
+        void takeSnapshot(Allocation& allocation) const noexcept;
+        static void copyHistory(Allocation& allocation) noexcept;
+
+        std::unique_ptr<typename Storage::Type[]> buffer;
         int bufferLength = 0;
         int writeIndex = 0; // where the most recent value was written
+        int writtenLength = 0; // samples written since reset, older ones read as zero
+        int64_t writeCount = 0; // samples written ever, reset doesn't touch it
+
+        // An allocation goes from the background thread to the audio thread
+        // and back through these, so each side owns it in turn.
+        std::atomic<int> requestedLength { 0 };
+        std::atomic<int> allocatedLength { 0 };
+        std::atomic<Allocation*> allocated { nullptr };  // waiting for a snapshot
+        std::atomic<Allocation*> copying { nullptr };  // waiting for the history
+        std::atomic<Allocation*> pending { nullptr };  // waiting to be swapped in
+        std::atomic<Allocation*> retired { nullptr };  // waiting to be freed
+
+        // keeps setMaximumDelayInSamples out while the background thread
+        // allocates or copies; never taken on the audio thread
+        std::mutex allocationLock;
 };
+
+using DelayLine = BasicDelayLine<float>;
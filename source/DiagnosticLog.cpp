@@ -0,0 +1,20 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#include "DiagnosticLog.h"
+
+void DiagnosticLog::drain(const std::function<void(const juce::String&)>& callback)
+{
+    int dropped = numDropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        callback(juce::String(dropped) + " diagnostic records dropped");
+    }
+
+    auto scope = fifo.read(fifo.getNumReady());
+    scope.forEach([&](int index) {
+        const Record& record = records[size_t(index)];
+        double seconds = juce::Time::highResolutionTicksToSeconds(record.ticks);
+        callback(juce::String(seconds, 6) + " "
+                 + juce::String::formatted(record.format, double(record.value1), double(record.value2)));
+    });
+}
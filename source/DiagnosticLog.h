@@ -0,0 +1,47 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+
+// Lets the audio thread log events without allocating or locking. push()
+// copies a fixed-size record into a lock-free single producer, single
+// consumer ring; drain() turns the records into text on another thread.
+//
+// The message is a printf format with up to two %g values. It must be a
+// string literal, since only the pointer is stored.
+class DiagnosticLog
+{
+public:
+    static constexpr int capacity = 256;
+
+    // Audio thread only. When the ring is full the record is dropped and
+    // counted, so a flood of events never blocks the audio.
+    void push(const char* format, float value1 = 0.0f, float value2 = 0.0f) noexcept
+    {
+        auto scope = fifo.write(1);
+        if (scope.blockSize1 == 0) {
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        records[size_t(scope.startIndex1)] = { format, value1, value2, juce::Time::getHighResolutionTicks() };
+    }
+
+    // Any one thread other than the audio thread. Formats the waiting
+    // records and hands each line to the callback, oldest first.
+    void drain(const std::function<void(const juce::String&)>& callback);
+
+private:
+    struct Record
+    {
+        const char* format;
+        float value1, value2;
+        juce::int64 ticks;
+    };
+
+    juce::AbstractFifo fifo { capacity };
+    std::array<Record, capacity> records {};
+    std::atomic<int> numDropped = 0;
+};
@@ -0,0 +1,49 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#include "FeedbackFilter.h"
+
+template <typename SampleType>
+typename BasicFeedbackFilter<SampleType>::Coefficients
+BasicFeedbackFilter<SampleType>::makeCoefficients(float frequency, double sampleRate) noexcept
+{
+    // same design as juce::dsp::StateVariableTPTFilter at its default
+    // resonance of 1/sqrt(2)
+    double g = std::tan(juce::MathConstants<double>::pi * double(frequency) / sampleRate);
+    double R2 = juce::MathConstants<double>::sqrt2;
+    double h = 1.0 / (1.0 + R2 * g + g * g);
+
+    return { Vec::expand(SampleType(g)), Vec::expand(SampleType(g + R2)), Vec::expand(SampleType(h)) };
+}
+
+template <typename SampleType>
+void BasicFeedbackFilter<SampleType>::prepare(double newSampleRate) noexcept
+{
+    jassert(newSampleRate > 0.0);
+    sampleRate = newSampleRate;
+    reset();
+}
+
+template <typename SampleType>
+void BasicFeedbackFilter<SampleType>::reset() noexcept
+{
+    lowS1 = lowS2 = Vec::expand(0);
+    highS1 = highS2 = Vec::expand(0);
+}
+
+template <typename SampleType>
+void BasicFeedbackFilter<SampleType>::setLowCut(float frequency) noexcept
+{
+    jassert(juce::isPositiveAndBelow(frequency, float(sampleRate * 0.5)));
+    lowCut = makeCoefficients(frequency, sampleRate);
+}
+
+template <typename SampleType>
+void BasicFeedbackFilter<SampleType>::setHighCut(float frequency) noexcept
+{
+    jassert(juce::isPositiveAndBelow(frequency, float(sampleRate * 0.5)));
+    highCut = makeCoefficients(frequency, sampleRate);
+}
+
+template class BasicFeedbackFilter<float>;
+template class BasicFeedbackFilter<double>;
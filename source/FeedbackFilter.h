@@ -0,0 +1,63 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+
+// The low cut and high cut in the feedback path, fused into one stereo
+// filter. Both are the same 12 dB/oct TPT state variable filter as
+// juce::dsp::StateVariableTPTFilter, but the left and right channels share
+// the lanes of a SIMD register, so a stereo sample through both filters is
+// a handful of vector operations. Templated on the sample type for the
+// float and double processing paths; a register holds at least two doubles.
+template <typename SampleType>
+class BasicFeedbackFilter
+{
+    public:
+        void prepare(double newSampleRate) noexcept;
+        void reset() noexcept;
+        void setLowCut(float frequency) noexcept;
+        void setHighCut(float frequency) noexcept;
+
+        void process(SampleType& left, SampleType& right) noexcept
+        {
+            alignas(Vec::SIMDRegisterSize) SampleType lanes[Vec::size()] = { left, right };
+            Vec x = Vec::fromRawArray(lanes);
+
+            // low cut: the highpass output of the first filter
+            Vec hp = (x - lowS1 * lowCut.gPlusR2 - lowS2) * lowCut.h;
+            Vec bp = hp * lowCut.g + lowS1;
+            lowS1 = hp * lowCut.g + bp;
+            Vec lp = bp * lowCut.g + lowS2;
+            lowS2 = bp * lowCut.g + lp;
+
+            // high cut: the lowpass output of the second filter
+            hp = (hp - highS1 * highCut.gPlusR2 - highS2) * highCut.h;
+            bp = hp * highCut.g + highS1;
+            highS1 = hp * highCut.g + bp;
+            lp = bp * highCut.g + highS2;
+            highS2 = bp * highCut.g + lp;
+
+            lp.copyToRawArray(lanes);
+            left = lanes[0];
+            right = lanes[1];
+        }
+
+    private:
+        using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+        // the same value in every lane
+        struct Coefficients
+        {
+            Vec g, gPlusR2, h;
+        };
+        static Coefficients makeCoefficients(float frequency, double sampleRate) noexcept;
+
+        double sampleRate = 44100.0;
+        Coefficients lowCut = makeCoefficients(20.0f, 44100.0);
+        Coefficients highCut = makeCoefficients(20000.0f, 44100.0);
+        Vec lowS1 = Vec::expand(0), lowS2 = Vec::expand(0);
+        Vec highS1 = Vec::expand(0), highS2 = Vec::expand(0);
+};
+
+using FeedbackFilter = BasicFeedbackFilter<float>;
@@ -0,0 +1,146 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#include "Kernels.h"
+#include <algorithm>
+#include <bit>
+
+// GCC and Clang can compile a function for a higher target than the rest of
+// the build. Elsewhere only the baseline is built.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define KERNELS_X86_LEVELS 1
+#else
+    #define KERNELS_X86_LEVELS 0
+#endif
+
+namespace
+{
+    using Storage = DelayLine::Storage;
+
+    // The kernel bodies. The functions for each level below are flattened,
+    // so these get inlined and vectorised for that level's target.
+    // Integer max over the magnitude bits, rather than float max over abs,
+    // so NaN can't get lost and fast-math can't assume it away.
+    inline uint32_t peakBitsLoop(const float* data, int numSamples) noexcept
+    {
+        uint32_t result = 0;
+        for (int i = 0; i < numSamples; ++i) {
+            result = std::max(result, std::bit_cast<uint32_t>(data[i]) & 0x7fffffffu);
+        }
+        return result;
+    }
+
+    // Integer max over the magnitude bits of the doubles, then narrowed to
+    // float, which keeps NaN a NaN and turns anything too large into infinity.
+    inline uint32_t peakBitsDoubleLoop(const double* data, int numSamples) noexcept
+    {
+        uint64_t result = 0;
+        for (int i = 0; i < numSamples; ++i) {
+            result = std::max(result, std::bit_cast<uint64_t>(data[i]) & 0x7fffffffffffffffu);
+        }
+        return std::bit_cast<uint32_t>(float(std::bit_cast<double>(result)));
+    }
+
+    inline void decodeLoop(const Storage::Type* source, float* destination, int numSamples) noexcept
+    {
+        Storage::decode(source, destination, numSamples);
+    }
+
+    // SSE2 on x86-64, NEON on arm64
+    uint32_t peakBitsBaseline(const float* data, int numSamples) noexcept
+    {
+        return peakBitsLoop(data, numSamples);
+    }
+    uint32_t peakBitsDoubleBaseline(const double* data, int numSamples) noexcept
+    {
+        return peakBitsDoubleLoop(data, numSamples);
+    }
+    void decodeBaseline(const Storage::Type* source, float* destination, int numSamples) noexcept
+    {
+        decodeLoop(source, destination, numSamples);
+    }
+
+    #if defined(__aarch64__) || defined(_M_ARM64)
+    constexpr const char* baselineName = "neon";
+    #elif defined(__x86_64__) || defined(_M_X64)
+    constexpr const char* baselineName = "sse2";
+    #else
+    constexpr const char* baselineName = "generic";
+    #endif
+
+    const Kernels baseline { baselineName, peakBitsBaseline, peakBitsDoubleBaseline, decodeBaseline };
+
+    #if KERNELS_X86_LEVELS
+    __attribute__((target("avx2,fma"), flatten))
+    uint32_t peakBitsAVX2(const float* data, int numSamples) noexcept
+    {
+        return peakBitsLoop(data, numSamples);
+    }
+    __attribute__((target("avx2,fma"), flatten))
+    uint32_t peakBitsDoubleAVX2(const double* data, int numSamples) noexcept
+    {
+        return peakBitsDoubleLoop(data, numSamples);
+    }
+    __attribute__((target("avx2,fma"), flatten))
+    void decodeAVX2(const Storage::Type* source, float* destination, int numSamples) noexcept
+    {
+        decodeLoop(source, destination, numSamples);
+    }
+
+    __attribute__((target("avx512f,avx512bw,avx512vl,avx2,fma"), flatten))
+    uint32_t peakBitsAVX512(const float* data, int numSamples) noexcept
+    {
+        return peakBitsLoop(data, numSamples);
+    }
+    __attribute__((target("avx512f,avx512bw,avx512vl,avx2,fma"), flatten))
+    uint32_t peakBitsDoubleAVX512(const double* data, int numSamples) noexcept
+    {
+        return peakBitsDoubleLoop(data, numSamples);
+    }
+    __attribute__((target("avx512f,avx512bw,avx512vl,avx2,fma"), flatten))
+    void decodeAVX512(const Storage::Type* source, float* destination, int numSamples) noexcept
+    {
+        decodeLoop(source, destination, numSamples);
+    }
+
+    const Kernels avx2 { "avx2", peakBitsAVX2, peakBitsDoubleAVX2, decodeAVX2 };
+    const Kernels avx512 { "avx512", peakBitsAVX512, peakBitsDoubleAVX512, decodeAVX512 };
+
+    bool hasAVX2() noexcept
+    {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    bool hasAVX512() noexcept
+    {
+        return hasAVX2() && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+            && __builtin_cpu_supports("avx512vl");
+    }
+    #endif
+}
+
+const Kernels& Kernels::select() noexcept
+{
+    #if KERNELS_X86_LEVELS
+    if (hasAVX512()) {
+        return avx512;
+    }
+    if (hasAVX2()) {
+        return avx2;
+    }
+    #endif
+    return baseline;
+}
+
+std::vector<const Kernels*> Kernels::getAvailable()
+{
+    std::vector<const Kernels*> result { &baseline };
+    #if KERNELS_X86_LEVELS
+    if (hasAVX2()) {
+        result.push_back(&avx2);
+    }
+    if (hasAVX512()) {
+        result.push_back(&avx512);
+    }
+    #endif
+    return result;
+}
@@ -0,0 +1,31 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "DelayLine.h"
+
+// Block kernels built for several instruction set levels. The bodies are
+// plain loops; each level is the same code compiled with a different target,
+// and select() returns the best one the CPU we're running on supports.
+struct Kernels
+{
+    const char* name;
+
+    // The largest absolute value in the block, as the bits of the float.
+    // Compared as integers, NaN ranks above infinity and infinity above any
+    // finite value, so one scan serves both metering and the output guard.
+    uint32_t (*peakBits)(const float* data, int numSamples) noexcept;
+
+    // the same for the double precision path, still as the bits of a float
+    uint32_t (*peakBitsDouble)(const double* data, int numSamples) noexcept;
+
+    // delay line storage to float, see DelayLine::ReadRegions::copyTo
+    DelayLine::DecodeFunction decode;
+
+    static const Kernels& select() noexcept;
+
+    // every level in this build that the CPU can run, best last
+    static std::vector<const Kernels*> getAvailable();
+};
@@ -10,8 +10,7 @@ LevelMeter::LevelMeter(Measurement& measurementL_, Measurement& measurementR_)
       dbLevelL(clampdB), dbLevelR(clampdB)
 {
     setOpaque(true);
-    startTimerHz(refreshRate);
-    decay = 1.0f - std::exp(-1.0f / (float(refreshRate) * 0.2f));
+    decay = 1.0f - std::exp(-1.0f / (float(refreshRate) * releaseTime));
 }
 
 LevelMeter::~LevelMeter()
@@ -20,13 +19,28 @@ LevelMeter::~LevelMeter()
 
 void LevelMeter::paint (juce::Graphics& g)
 {
-    const auto bounds = getLocalBounds();
-
     g.fillAll(Colors::LevelMeter::background);
 
     drawLevel(g, dbLevelL, 0, 7);
     drawLevel(g, dbLevelR, 9, 7);
 
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!scaleCache.isValid() || scale != scaleCacheScale) {
+        scaleCache = juce::Image(juce::Image::ARGB,
+                                 juce::roundToInt(float(getWidth()) * scale),
+                                 juce::roundToInt(float(getHeight()) * scale), true);
+        scaleCacheScale = scale;
+        juce::Graphics scaleGraphics(scaleCache);
+        scaleGraphics.addTransform(juce::AffineTransform::scale(scale));
+        drawScale(scaleGraphics);
+    }
+    g.drawImage(scaleCache, getLocalBounds().toFloat());
+}
+
+void LevelMeter::drawScale(juce::Graphics& g)
+{
+    const auto bounds = getLocalBounds();
+
     g.setFont(Fonts::getFont(10.0f));
     for (float db = maxdB; db >= mindB; db -= stepdB) {
         int y = positionForLevel(db);
@@ -44,14 +58,45 @@ void LevelMeter::resized()
 {
     maxPos = 4.0f;
     minPos = float(getHeight()) - 4.0f;
+    scaleCache = {};
 }
 
-void LevelMeter::timerCallback()
+void LevelMeter::update()
 {
-    updateLevel(measurementL.readAndReset(), levelL, dbLevelL);
-    updateLevel(measurementR.readAndReset(), levelR, dbLevelR);
+    // the display's frame rate varies, so the release follows the clock
+    double now = juce::Time::getMillisecondCounterHiRes();
+    if (lastUpdateTime > 0.0) {
+        float seconds = float(now - lastUpdateTime) * 0.001f;
+        decay = 1.0f - std::exp(-seconds / releaseTime);
+    }
+    lastUpdateTime = now;
 
-    repaint();
+    float newL = measurementL.readAndReset();
+    float newR = measurementR.readAndReset();
+
+    // silent and already at the floor: nothing to do
+    if (newL <= clampLevel && newR <= clampLevel && dbLevelL == clampdB && dbLevelR == clampdB) {
+        return;
+    }
+
+    int oldYL = positionForLevel(dbLevelL);
+    int oldYR = positionForLevel(dbLevelR);
+    updateLevel(newL, levelL, dbLevelL);
+    updateLevel(newR, levelR, dbLevelR);
+
+    repaintBar(0, 7, oldYL, positionForLevel(dbLevelL));
+    repaintBar(9, 7, oldYR, positionForLevel(dbLevelR));
+}
+
+// Only the part of the bar between the old and new level has changed.
+void LevelMeter::repaintBar(int x, int width, int oldY, int newY)
+{
+    if (oldY == newY) {
+        return;
+    }
+    int top = std::max(0, std::min(oldY, newY));
+    int bottom = std::min(getHeight(), std::max(oldY, newY));
+    repaint(x, top, width, bottom - top);
 }
 
 void LevelMeter::drawLevel(juce::Graphics& g, float level, int x, int width)
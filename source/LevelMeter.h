@@ -6,7 +6,7 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "Measurement.h"
 
-class LevelMeter : public juce::Component, private juce::Timer
+class LevelMeter : public juce::Component
 {
 public:
     LevelMeter(Measurement& measurementL,
@@ -15,6 +15,9 @@ public:
 
     void paint(juce::Graphics&) override;
     void resized() override;
+
+    // Called by the editor once per display frame.
+    void update();
 private:
     static constexpr float maxdB = 6.0f;
     static constexpr float mindB = -60.0f;
@@ -31,14 +34,21 @@ private:
         maxdB, mindB,
         maxPos, minPos)));
     }
-    void timerCallback() override;
     void drawLevel(juce::Graphics& g, float level, int x, int width);
-    static constexpr int refreshRate = 60;
+    void repaintBar(int x, int width, int oldY, int newY);
+    void drawScale(juce::Graphics& g);
+    static constexpr int refreshRate = 60;  // until the real frame rate is known
+    static constexpr float releaseTime = 0.2f;  // seconds
     float decay = 0.0f;
+    double lastUpdateTime = 0.0;
     float levelL = clampLevel;
     float levelR = clampLevel;
     void updateLevel(float newLevel, float& smoothedLevel, float& leveldB) const;
     Measurement& measurementL;
     Measurement& measurementR;
+
+    // tick lines and dB labels, drawn once per size and display scale
+    juce::Image scaleCache;
+    float scaleCacheScale = 1.0f;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeter)
 };
@@ -30,41 +30,18 @@ void RotaryKnobLookAndFeel::drawRotarySlider(
     juce::Slider& slider)
 {
     auto bounds = juce::Rectangle<int>(x, y, width, width).toFloat();
-    auto knobRect = bounds.reduced(10.0f, 10.0f);
+    auto innerRect = bounds.reduced(12.0f, 12.0f);
 
-    auto path = juce::Path();
-    path.addEllipse(knobRect);
-    dropShadow.drawForPath(g, path);
-
-    g.setColour(Colors::Knob::outline);
-    g.fillEllipse(knobRect);
-
-    auto innerRect = knobRect.reduced(2.0f, 2.0f);
-    auto gradient = juce::ColourGradient(
-        Colors::Knob::gradientTop, 0.0f, innerRect.getY(),
-        Colors::Knob::gradientBottom, 0.0f, innerRect.getBottom(), false);
-    g.setGradientFill(gradient);
-    g.fillEllipse(innerRect);
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    g.drawImage(getKnobImage(width, rotaryStartAngle, rotaryEndAngle, scale), bounds);
 
     auto center = bounds.getCentre();
     auto radius = bounds.getWidth() / 2.0f;
     auto lineWidth = 3.0f;
     auto arcRadius = radius - lineWidth/2.0f;
 
-    juce::Path backgroundArc;
-    backgroundArc.addCentredArc(center.x,
-                                center.y,
-                                arcRadius,
-                                arcRadius,
-                                0.0f,
-                                rotaryStartAngle,
-                                rotaryEndAngle,
-                                true);
-
     auto strokeType = juce::PathStrokeType(
         lineWidth, juce::PathStrokeType::curved, juce::PathStrokeType::rounded);
-    g.setColour(Colors::Knob::trackBackground);
-    g.strokePath(backgroundArc, strokeType);
 
     auto dialRadius = innerRect.getHeight()/2.0f - lineWidth;
     auto toAngle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
@@ -95,11 +72,96 @@ void RotaryKnobLookAndFeel::drawRotarySlider(
     }
 }
 
+juce::Image RotaryKnobLookAndFeel::getKnobImage(
+    int width, float rotaryStartAngle, float rotaryEndAngle, float scale)
+{
+    for (auto& cached : knobCache) {
+        if (cached.width == width && cached.scale == scale
+            && cached.rotaryStartAngle == rotaryStartAngle && cached.rotaryEndAngle == rotaryEndAngle) {
+            return cached.image;
+        }
+    }
+
+    int pixels = juce::roundToInt(float(width) * scale);
+    juce::Image image(juce::Image::ARGB, pixels, pixels, true);
+    juce::Graphics g(image);
+    g.addTransform(juce::AffineTransform::scale(float(pixels) / float(width)));
+    drawKnobBody(g, float(width), rotaryStartAngle, rotaryEndAngle);
+
+    // the image is reference counted, so the copy stays valid whatever
+    // happens to the vector later
+    knobCache.push_back({ width, rotaryStartAngle, rotaryEndAngle, scale, image });
+    return image;
+}
+
+void RotaryKnobLookAndFeel::drawKnobBody(
+    juce::Graphics& g, float width, float rotaryStartAngle, float rotaryEndAngle)
+{
+    auto bounds = juce::Rectangle<float>(0.0f, 0.0f, width, width);
+    auto knobRect = bounds.reduced(10.0f, 10.0f);
+
+    auto path = juce::Path();
+    path.addEllipse(knobRect);
+    dropShadow.drawForPath(g, path);
+
+    g.setColour(Colors::Knob::outline);
+    g.fillEllipse(knobRect);
+
+    auto innerRect = knobRect.reduced(2.0f, 2.0f);
+    auto gradient = juce::ColourGradient(
+        Colors::Knob::gradientTop, 0.0f, innerRect.getY(),
+        Colors::Knob::gradientBottom, 0.0f, innerRect.getBottom(), false);
+    g.setGradientFill(gradient);
+    g.fillEllipse(innerRect);
+
+    auto center = bounds.getCentre();
+    auto radius = bounds.getWidth() / 2.0f;
+    auto lineWidth = 3.0f;
+    auto arcRadius = radius - lineWidth/2.0f;
+
+    juce::Path backgroundArc;
+    backgroundArc.addCentredArc(center.x,
+                                center.y,
+                                arcRadius,
+                                arcRadius,
+                                0.0f,
+                                rotaryStartAngle,
+                                rotaryEndAngle,
+                                true);
+
+    auto strokeType = juce::PathStrokeType(
+        lineWidth, juce::PathStrokeType::curved, juce::PathStrokeType::rounded);
+    g.setColour(Colors::Knob::trackBackground);
+    g.strokePath(backgroundArc, strokeType);
+}
+
 juce::Font RotaryKnobLookAndFeel::getLabelFont([[maybe_unused]] juce::Label& label)
 {
     return Fonts::getFont();
 }
 
+// The knob names are static text and come from the AssetCache. The value
+// boxes change all the time and are drawn as usual.
+void RotaryKnobLookAndFeel::drawLabel(juce::Graphics& g, juce::Label& label)
+{
+    if (!label.getProperties()["staticText"] || label.isBeingEdited()) {
+        LookAndFeel_V4::drawLabel(g, label);
+        return;
+    }
+
+    // every processor holds one, so this only takes a reference
+    juce::SharedResourcePointer<AssetCache> assets;
+
+    g.fillAll(label.findColour(juce::Label::backgroundColourId));
+    float alpha = label.isEnabled() ? 1.0f : 0.5f;
+    g.setColour(label.findColour(juce::Label::textColourId).withMultipliedAlpha(alpha));
+    auto textArea = getLabelBorderSize(label).subtractedFrom(label.getLocalBounds());
+    assets->drawStaticText(g, label.getText(), getLabelFont(label), textArea.toFloat(),
+                           label.getJustificationType());
+    g.setColour(label.findColour(juce::Label::outlineColourId).withMultipliedAlpha(alpha));
+    g.drawRect(label.getLocalBounds());
+}
+
 class RotaryKnobLabel : public juce::Label
 {
 public:
@@ -159,6 +221,56 @@ juce::Font MainLookAndFeel::getLabelFont([[maybe_unused]] juce::Label& label)
     return Fonts::getFont();
 }
 
+void MainLookAndFeel::drawGroupComponentOutline(
+    juce::Graphics& g, int width, int height, const juce::String& text,
+    const juce::Justification& position, juce::GroupComponent& group)
+{
+    const float textH = 15.0f;
+    const float indent = 3.0f;
+    const float textEdgeGap = 4.0f;
+    float cs = 5.0f;
+
+    juce::Font font(withDefaultMetrics(juce::FontOptions { textH }));
+
+    float x = indent;
+    float y = font.getAscent() - 3.0f;
+    float w = std::max(0.0f, float(width) - x * 2.0f);
+    float h = std::max(0.0f, float(height) - y - indent);
+    cs = std::min({ cs, w * 0.5f, h * 0.5f });
+    float cs2 = 2.0f * cs;
+
+    float textW = text.isEmpty() ? 0.0f
+        : juce::jlimit(0.0f, std::max(0.0f, w - cs2 - textEdgeGap * 2.0f),
+                       assets->getStaticTextWidth(text, font) + textEdgeGap * 2.0f);
+    float textX = cs + textEdgeGap;
+    if (position.testFlags(juce::Justification::horizontallyCentred)) {
+        textX = cs + (w - cs2 - textW) * 0.5f;
+    } else if (position.testFlags(juce::Justification::right)) {
+        textX = w - cs - textW - textEdgeGap;
+    }
+
+    // the outline, with a gap for the title
+    juce::Path p;
+    float pi = juce::MathConstants<float>::pi;
+    p.startNewSubPath(x + textX + textW, y);
+    p.lineTo(x + w - cs, y);
+    p.addArc(x + w - cs2, y, cs2, cs2, 0.0f, 0.5f * pi);
+    p.lineTo(x + w, y + h - cs);
+    p.addArc(x + w - cs2, y + h - cs2, cs2, cs2, 0.5f * pi, pi);
+    p.lineTo(x + cs, y + h);
+    p.addArc(x, y + h - cs2, cs2, cs2, pi, 1.5f * pi);
+    p.lineTo(x, y + cs);
+    p.addArc(x, y, cs2, cs2, 1.5f * pi, 2.0f * pi);
+    p.lineTo(x + textX, y);
+
+    float alpha = group.isEnabled() ? 1.0f : 0.5f;
+    g.setColour(group.findColour(juce::GroupComponent::outlineColourId).withMultipliedAlpha(alpha));
+    g.strokePath(p, juce::PathStrokeType(2.0f));
+
+    g.setColour(group.findColour(juce::GroupComponent::textColourId).withMultipliedAlpha(alpha));
+    assets->drawStaticText(g, text, font, { x + textX, 0.0f, textW, textH }, juce::Justification::centred);
+}
+
 ButtonLookAndFeel::ButtonLookAndFeel()
 {
     setColour(juce::TextButton::textColourOffId, Colors::Button::text);
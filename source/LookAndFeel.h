@@ -3,6 +3,7 @@
 //
 #pragma once
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "AssetCache.h"
 
 namespace Colors
 {
@@ -47,6 +48,19 @@ namespace Colors
         const juce::Colour tooLoud { 226, 74, 81 };
         const juce::Colour levelOK { 65, 206, 88 };
     }
+
+    namespace Scope
+    {
+        const juce::Colour background { 245, 240, 235 };
+        const juce::Colour centerLine { 200, 200, 200 };
+        const juce::Colour dry { 205, 200, 195 };
+        const juce::Colour wet { 177, 101, 135 };
+    }
+
+    namespace Loudness
+    {
+        const juce::Colour text { 200, 200, 200 };  // on the header
+    }
 }
 
 class Fonts
@@ -66,6 +80,7 @@ public:
     RotaryKnobLookAndFeel();
 
     juce::Font getLabelFont(juce::Label&) override;
+    void drawLabel(juce::Graphics&, juce::Label&) override;
 
     juce::Label* createSliderTextBox(juce::Slider&) override;
 
@@ -85,6 +100,21 @@ public:
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RotaryKnobLookAndFeel)
 
+    // The parts of a knob that don't move with its value: the shadow, the
+    // body and the background track. They are rendered once per knob size,
+    // rotary range and display scale, and shared by all knobs in all editors.
+    juce::Image getKnobImage(int width, float rotaryStartAngle, float rotaryEndAngle, float scale);
+    void drawKnobBody(juce::Graphics& g, float width, float rotaryStartAngle, float rotaryEndAngle);
+
+    struct CachedKnob
+    {
+        int width;
+        float rotaryStartAngle, rotaryEndAngle;
+        float scale;
+        juce::Image image;
+    };
+    std::vector<CachedKnob> knobCache;
+
     juce::DropShadow dropShadow { Colors::Knob::dropShadow, 6, { 0, 3 } };
 };
 
@@ -95,7 +125,13 @@ public:
 
     juce::Font getLabelFont(juce::Label&) override;
 
+    // as LookAndFeel_V2 draws it, with the title from the AssetCache
+    void drawGroupComponentOutline(juce::Graphics&, int width, int height, const juce::String& text,
+                                   const juce::Justification&, juce::GroupComponent&) override;
+
 private:
+    juce::SharedResourcePointer<AssetCache> assets;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainLookAndFeel)
 };
 
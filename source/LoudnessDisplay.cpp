@@ -0,0 +1,49 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#include "LoudnessDisplay.h"
+#include "LookAndFeel.h"
+
+LoudnessDisplay::LoudnessDisplay(LoudnessMeter& loudnessMeter_) : loudnessMeter(loudnessMeter_)
+{
+}
+
+void LoudnessDisplay::paint(juce::Graphics& g)
+{
+    g.setFont(Fonts::getFont(12.0f));
+    g.setColour(overTruePeakLimit ? Colors::LevelMeter::tooLoud : Colors::Loudness::text);
+    g.drawFittedText(text, getLocalBounds(), juce::Justification::centredLeft, 1);
+}
+
+void LoudnessDisplay::mouseDown(const juce::MouseEvent&)
+{
+    loudnessMeter.resetTruePeak();
+}
+
+void LoudnessDisplay::update()
+{
+    double now = juce::Time::getMillisecondCounterHiRes();
+    if (now - lastUpdateTime < 1000.0 / refreshRate) {
+        return;
+    }
+    lastUpdateTime = now;
+
+    float truePeak = loudnessMeter.getTruePeak();
+    juce::String newText = "M " + format(loudnessMeter.getMomentaryLoudness())
+                         + "  S " + format(loudnessMeter.getShortTermLoudness())
+                         + "  TP " + format(truePeak);
+    bool newOver = truePeak > -1.0f;  // the usual delivery limit of -1 dBTP
+    if (newText != text || newOver != overTruePeakLimit) {
+        text = newText;
+        overTruePeakLimit = newOver;
+        repaint();
+    }
+}
+
+juce::String LoudnessDisplay::format(float value)
+{
+    if (value <= LoudnessMeter::silence) {
+        return "-inf";
+    }
+    return juce::String(value, 1);
+}
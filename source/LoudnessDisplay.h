@@ -0,0 +1,30 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "LoudnessMeter.h"
+
+// Shows the momentary and short-term loudness and the true peak as text.
+// Click it to reset the true peak.
+class LoudnessDisplay : public juce::Component
+{
+public:
+    explicit LoudnessDisplay(LoudnessMeter& loudnessMeter);
+
+    void paint(juce::Graphics&) override;
+    void mouseDown(const juce::MouseEvent&) override;
+
+    // Called by the editor once per display frame, updates at refreshRate.
+    void update();
+
+private:
+    static juce::String format(float value);
+
+    static constexpr int refreshRate = 10;
+    LoudnessMeter& loudnessMeter;
+    double lastUpdateTime = 0.0;
+    juce::String text;
+    bool overTruePeakLimit = false;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessDisplay)
+};
@@ -0,0 +1,137 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#include "LoudnessMeter.h"
+
+void LoudnessMeter::prepare(double sampleRate)
+{
+    const juce::ScopedLock lock(processLock);
+
+    // The K-weighting filters from BS.1770, with the coefficients worked out
+    // for any sample rate rather than just the 48 kHz ones in the standard.
+    const double pi = juce::MathConstants<double>::pi;
+    double K = std::tan(pi * 1681.974450955533 / sampleRate);
+    double Q = 0.7071752369554196;
+    double Vh = std::pow(10.0, 3.999843853973347 / 20.0);
+    double Vb = std::pow(Vh, 0.4996667741545416);
+    double a0 = 1.0 + K / Q + K * K;
+    Biquad shelf;
+    shelf.b0 = (Vh + Vb * K / Q + K * K) / a0;
+    shelf.b1 = 2.0 * (K * K - Vh) / a0;
+    shelf.b2 = (Vh - Vb * K / Q + K * K) / a0;
+    shelf.a1 = 2.0 * (K * K - 1.0) / a0;
+    shelf.a2 = (1.0 - K / Q + K * K) / a0;
+
+    K = std::tan(pi * 38.13547087602444 / sampleRate);
+    Q = 0.5003270373238773;
+    a0 = 1.0 + K / Q + K * K;
+    Biquad highpass;
+    highpass.b0 = 1.0;
+    highpass.b1 = -2.0;
+    highpass.b2 = 1.0;
+    highpass.a1 = 2.0 * (K * K - 1.0) / a0;
+    highpass.a2 = (1.0 - K / Q + K * K) / a0;
+
+    for (auto& channel : channels) {
+        channel.shelf = shelf;
+        channel.highpass = highpass;
+        channel.oversampler.setFactor(4);
+        channel.sumOfSquares = 0.0;
+    }
+
+    samplesPerBlock = std::max(1, int(std::round(sampleRate / 10.0)));
+    samplesInBlock = 0;
+    blockPowers.fill(0.0);
+    blockIndex = 0;
+    numBlocks = 0;
+    peak = 0.0f;
+    fifo.reset();
+
+    momentary.store(silence);
+    shortTerm.store(silence);
+    truePeak.store(silence);
+}
+
+template <typename SampleType>
+void LoudnessMeter::push(const SampleType* left, const SampleType* right, int numSamples) noexcept
+{
+    numChannels.store(right != nullptr ? 2 : 1, std::memory_order_relaxed);
+
+    auto scope = fifo.write(std::min(numSamples, fifo.getFreeSpace()));
+    if (scope.blockSize1 > 0) {
+        std::copy(left, left + scope.blockSize1, fifoData[0].data() + scope.startIndex1);
+        std::copy(left + scope.blockSize1, left + scope.blockSize1 + scope.blockSize2, fifoData[0].data() + scope.startIndex2);
+        if (right != nullptr) {
+            std::copy(right, right + scope.blockSize1, fifoData[1].data() + scope.startIndex1);
+            std::copy(right + scope.blockSize1, right + scope.blockSize1 + scope.blockSize2, fifoData[1].data() + scope.startIndex2);
+        }
+    }
+}
+
+template void LoudnessMeter::push(const float*, const float*, int) noexcept;
+template void LoudnessMeter::push(const double*, const double*, int) noexcept;
+
+void LoudnessMeter::process()
+{
+    const juce::ScopedLock lock(processLock);
+
+    if (truePeakResetRequested.exchange(false, std::memory_order_relaxed)) {
+        peak = 0.0f;
+        truePeak.store(silence, std::memory_order_relaxed);
+    }
+
+    int channelCount = numChannels.load(std::memory_order_relaxed);
+    auto scope = fifo.read(fifo.getNumReady());
+    bool newBlocks = false;
+
+    scope.forEach([&](int index) {
+        for (int ch = 0; ch < channelCount; ++ch) {
+            Channel& channel = channels[size_t(ch)];
+            float x = fifoData[size_t(ch)][size_t(index)];
+
+            double weighted = channel.highpass.process(channel.shelf.process(double(x)));
+            channel.sumOfSquares += weighted * weighted;
+
+            channel.oversampler.push(x);
+            for (int i = 0; i < 4; ++i) {
+                peak = std::max(peak, std::abs(channel.oversampler.process()));
+            }
+        }
+
+        if (++samplesInBlock == samplesPerBlock) {
+            double power = 0.0;
+            for (int ch = 0; ch < channelCount; ++ch) {
+                power += channels[size_t(ch)].sumOfSquares / double(samplesPerBlock);
+                channels[size_t(ch)].sumOfSquares = 0.0;
+            }
+            blockPowers[size_t(blockIndex)] = power;
+            blockIndex = (blockIndex + 1) % shortTermBlocks;
+            numBlocks = std::min(numBlocks + 1, shortTermBlocks);
+            samplesInBlock = 0;
+            newBlocks = true;
+        }
+    });
+
+    if (newBlocks) {
+        momentary.store(toLoudness(momentaryBlocks), std::memory_order_relaxed);
+        shortTerm.store(toLoudness(shortTermBlocks), std::memory_order_relaxed);
+    }
+    truePeak.store(juce::Decibels::gainToDecibels(peak, silence), std::memory_order_relaxed);
+}
+
+// The loudness over the most recent numBlocksToAverage blocks, in LUFS.
+float LoudnessMeter::toLoudness(int numBlocksToAverage) const noexcept
+{
+    if (numBlocks < numBlocksToAverage) {
+        return silence;  // not enough audio yet
+    }
+    double sum = 0.0;
+    for (int i = 1; i <= numBlocksToAverage; ++i) {
+        sum += blockPowers[size_t((blockIndex - i + shortTermBlocks) % shortTermBlocks)];
+    }
+    double meanPower = sum / double(numBlocksToAverage);
+    if (meanPower <= 0.0) {
+        return silence;
+    }
+    return std::max(silence, float(-0.691 + 10.0 * std::log10(meanPower)));
+}
@@ -0,0 +1,86 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+#include "Resampler.h"
+
+// K-weighted loudness (ITU-R BS.1770: momentary over 400 ms, short-term
+// over 3 s) and 4x oversampled true peak of the output.
+//
+// The audio thread only copies its output into a lock-free FIFO with push().
+// process() does the filtering and oversampling; the processor calls it from
+// the shared background thread. The results can be read from any thread.
+class LoudnessMeter
+{
+public:
+    static constexpr float silence = -100.0f;  // what "no signal" reads as
+
+    // Message thread, not while the audio thread is pushing.
+    void prepare(double sampleRate);
+
+    // Audio thread. right is nullptr for a mono output. Samples that don't
+    // fit because process() has fallen behind are left out. Double samples
+    // are stored as float.
+    template <typename SampleType>
+    void push(const SampleType* left, const SampleType* right, int numSamples) noexcept;
+
+    // Background thread.
+    void process();
+
+    float getMomentaryLoudness() const noexcept { return momentary.load(std::memory_order_relaxed); }
+    float getShortTermLoudness() const noexcept { return shortTerm.load(std::memory_order_relaxed); }
+
+    // highest true peak in dBTP since the last resetTruePeak()
+    float getTruePeak() const noexcept { return truePeak.load(std::memory_order_relaxed); }
+    void resetTruePeak() noexcept { truePeakResetRequested.store(true, std::memory_order_relaxed); }
+
+private:
+    static constexpr int fifoSize = 32768;
+    static constexpr int momentaryBlocks = 4;   // of 100 ms
+    static constexpr int shortTermBlocks = 30;
+
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double z1 = 0.0, z2 = 0.0;
+
+        double process(double x) noexcept
+        {
+            double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    // everything kept per channel on the background thread
+    struct Channel
+    {
+        Biquad shelf, highpass;
+        Interpolator oversampler;
+        double sumOfSquares = 0.0;
+    };
+
+    float toLoudness(int numBlocks) const noexcept;
+
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<std::vector<float>, 2> fifoData { std::vector<float>(fifoSize), std::vector<float>(fifoSize) };
+    std::atomic<int> numChannels = 2;
+
+    juce::CriticalSection processLock;  // prepare() against process()
+    std::array<Channel, 2> channels;
+    int samplesPerBlock = 4800;
+    int samplesInBlock = 0;
+    std::array<double, shortTermBlocks> blockPowers {};  // mean square of the last 100 ms blocks
+    int blockIndex = 0;
+    int numBlocks = 0;
+    float peak = 0.0f;
+
+    std::atomic<float> momentary = silence;
+    std::atomic<float> shortTerm = silence;
+    std::atomic<float> truePeak = silence;
+    std::atomic<bool> truePeakResetRequested = false;
+};
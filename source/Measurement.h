@@ -4,6 +4,11 @@
 
 #pragma once
 #include <atomic>
+#include <cstddef>
+
+// At least the cache line size of the CPUs we run on: 64 bytes on x86,
+// 128 on Apple silicon.
+inline constexpr size_t cacheLineSize = 128;
 
 struct Measurement
 {
@@ -23,3 +28,11 @@ struct Measurement
     }
     std::atomic<float> value;
 };
+
+// What the audio thread publishes for the editor's meters, once per block.
+// The editor polls these from the message thread, so they get a cache line
+// of their own, away from the DSP state the audio thread is working on.
+struct alignas(cacheLineSize) Meters
+{
+    Measurement levelL, levelR;
+};
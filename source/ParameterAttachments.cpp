@@ -0,0 +1,114 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#include "ParameterAttachments.h"
+
+PolledSliderAttachment::PolledSliderAttachment(juce::RangedAudioParameter& parameter_, juce::Slider& slider_)
+    : parameter(parameter_), slider(slider_)
+{
+    // give the slider the parameter's range, text conversion and default,
+    // the same way juce::SliderParameterAttachment does
+    auto range = parameter.getNormalisableRange();
+    auto convertFrom0To1 = [range](double start, double end, double normalisedValue) mutable {
+        range.start = float(start);
+        range.end = float(end);
+        return double(range.convertFrom0to1(float(normalisedValue)));
+    };
+    auto convertTo0To1 = [range](double start, double end, double mappedValue) mutable {
+        range.start = float(start);
+        range.end = float(end);
+        return double(range.convertTo0to1(float(mappedValue)));
+    };
+    auto snapToLegalValue = [range](double start, double end, double mappedValue) mutable {
+        range.start = float(start);
+        range.end = float(end);
+        return double(range.snapToLegalValue(float(mappedValue)));
+    };
+    juce::NormalisableRange<double> sliderRange { double(range.start), double(range.end),
+                                                  convertFrom0To1, convertTo0To1, snapToLegalValue };
+    sliderRange.interval = double(range.interval);
+    sliderRange.skew = double(range.skew);
+    sliderRange.symmetricSkew = range.symmetricSkew;
+    slider.setNormalisableRange(sliderRange);
+
+    slider.valueFromTextFunction = [this](const juce::String& text) {
+        return double(parameter.convertFrom0to1(parameter.getValueForText(text)));
+    };
+    slider.textFromValueFunction = [this](double value) {
+        return parameter.getText(parameter.convertTo0to1(float(value)), 0);
+    };
+    slider.setDoubleClickReturnValue(true, double(parameter.convertFrom0to1(parameter.getDefaultValue())));
+
+    slider.onValueChange = [this] { sliderValueChanged(); };
+    slider.onDragStart = [this] {
+        dragging = true;
+        parameter.beginChangeGesture();
+    };
+    slider.onDragEnd = [this] {
+        parameter.endChangeGesture();
+        dragging = false;
+    };
+
+    update();
+}
+
+PolledSliderAttachment::~PolledSliderAttachment()
+{
+    slider.onValueChange = nullptr;
+    slider.onDragStart = nullptr;
+    slider.onDragEnd = nullptr;
+}
+
+void PolledSliderAttachment::update()
+{
+    float value = parameter.getValue();
+    if (value != lastValue) {
+        lastValue = value;
+        slider.setValue(double(parameter.convertFrom0to1(value)), juce::dontSendNotification);
+    }
+}
+
+void PolledSliderAttachment::sliderValueChanged()
+{
+    float value = parameter.convertTo0to1(float(slider.getValue()));
+    if (value == lastValue) {
+        return;
+    }
+    lastValue = value;
+    if (dragging) {
+        parameter.setValueNotifyingHost(value);
+    } else {  // typed in, double-clicked or scrolled
+        parameter.beginChangeGesture();
+        parameter.setValueNotifyingHost(value);
+        parameter.endChangeGesture();
+    }
+}
+
+PolledButtonAttachment::PolledButtonAttachment(juce::RangedAudioParameter& parameter_, juce::Button& button_)
+    : parameter(parameter_), button(button_)
+{
+    button.onClick = [this] {
+        float value = button.getToggleState() ? 1.0f : 0.0f;
+        if (value != lastValue) {
+            lastValue = value;
+            parameter.beginChangeGesture();
+            parameter.setValueNotifyingHost(value);
+            parameter.endChangeGesture();
+        }
+    };
+    update();
+}
+
+PolledButtonAttachment::~PolledButtonAttachment()
+{
+    button.onClick = nullptr;
+}
+
+void PolledButtonAttachment::update()
+{
+    float value = parameter.getValue();
+    if (value != lastValue) {
+        lastValue = value;
+        button.setToggleState(value >= 0.5f, juce::dontSendNotification);
+    }
+}
@@ -0,0 +1,48 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// Attachments between a parameter and a control that don't listen to the
+// parameter. The editor calls update() once per display frame, and the
+// control is only touched when the value has changed since the last frame.
+// However fast the host automates, that's at most one repaint per control
+// per frame, and nothing is ever posted to the message thread from the
+// audio thread.
+//
+// Changes made in the UI go to the host straight away, with gestures, like
+// the APVTS attachments do.
+
+class PolledSliderAttachment
+{
+public:
+    PolledSliderAttachment(juce::RangedAudioParameter& parameter, juce::Slider& slider);
+    ~PolledSliderAttachment();
+
+    void update();
+
+private:
+    void sliderValueChanged();
+
+    juce::RangedAudioParameter& parameter;
+    juce::Slider& slider;
+    float lastValue = -1.0f;  // normalised
+    bool dragging = false;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PolledSliderAttachment)
+};
+
+class PolledButtonAttachment
+{
+public:
+    PolledButtonAttachment(juce::RangedAudioParameter& parameter, juce::Button& button);
+    ~PolledButtonAttachment();
+
+    void update();
+
+private:
+    juce::RangedAudioParameter& parameter;
+    juce::Button& button;
+    float lastValue = -1.0f;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PolledButtonAttachment)
+};
@@ -4,13 +4,6 @@
 #include "Parameters.h"
 #include "DSP.h"
 
-template<typename T>
-static void castParameter(juce::AudioProcessorValueTreeState& apvts, const juce::ParameterID& id, T& destination)
-{
-    destination = dynamic_cast<T>(apvts.getParameter(id.getParamID()));
-    jassert(destination);
-}
-
 static juce::String stringFromMilliseconds(float value, int)
 {
     if (value < 10.0f){
@@ -67,61 +60,54 @@ static float millisecondsFromString(const juce::String& text)
     return value;
 }
 
-// creates our Parameters object
-Parameters::Parameters(juce::AudioProcessorValueTreeState& apvts)
+namespace
 {
-    castParameter (apvts, gainParamID, gainParam);
-    castParameter (apvts, delayTimeParamID, delayTimeParam);
-    castParameter (apvts, mixParamID, mixParam);
-    castParameter (apvts, feedbackParamID, feedbackParam);
-    castParameter (apvts, stereoParamID, stereoParam);
-    castParameter (apvts, lowCutParamID, lowCutParam);
-    castParameter (apvts, highCutParamID, highCutParam);
-    castParameter (apvts, tempoSyncParamID, tempoSyncParam);
-    castParameter (apvts, delayNoteParamID, delayNoteParam);
-    castParameter (apvts, bypassParamID, bypassParam);
-}
+// Everything about the float parameters that is the same for every
+// instance, in the order they are added to the layout. Built at compile
+// time, so constructing a plugin only has to turn it into objects.
+struct FloatParameterSpec
+{
+    const juce::ParameterID* id;
+    const char* name;
+    float minimum, maximum, interval, skew, defaultValue;
+    juce::String (*stringFromValue)(float, int);
+    float (*valueFromString)(const juce::String&);  // nullptr for JUCE's default
+};
 
-// the function fills out the ParameterLayout object and returns it
-// the purpos of the ParameterLayout object is to describe the
-// parameter objects that should be added to the APVTS
-juce::AudioProcessorValueTreeState::ParameterLayout Parameters::createParameterLayout()
+constexpr FloatParameterSpec floatParameters[] = {
+    { &gainParamID, "Output Gain", -12.0f, 12.0f, 0.0f, 1.0f, 0.0f, stringFromDecibels, nullptr },
+    { &delayTimeParamID, "Delay Time", Parameters::minDelayTime, Parameters::maxDelayTime, 0.001f, 0.25f, 100.0f,
+      stringFromMilliseconds, millisecondsFromString },
+    { &mixParamID, "Mix", 0.0f, 100.0f, 1.0f, 1.0f, 100.0f, stringFromPercent, nullptr },
+    { &feedbackParamID, "Feedback", -100.0f, 100.0f, 1.0f, 1.0f, 0.0f, stringFromPercent, nullptr },
+    { &stereoParamID, "Stereo", -100.0f, 100.0f, 1.0f, 1.0f, 0.0f, stringFromPercent, nullptr },
+    { &lowCutParamID, "Low Cut", 20.0f, 20000.0f, 1.0f, 0.3f, 20.0f, stringFromHz, hzFromString },
+    { &highCutParamID, "High Cut", 0.0f, 20000.0f, 1.0f, 0.3f, 20000.0f, stringFromHz, hzFromString },
+};
+
+// position of each parameter in the layout, and so in the processor
+enum ParameterIndex
 {
-    // create the layout object
-    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    gainIndex,
+    delayTimeIndex,
+    mixIndex,
+    feedbackIndex,
+    stereoIndex,
+    lowCutIndex,
+    highCutIndex,
+    tempoSyncIndex,
+    delayNoteIndex,
+    bypassIndex,
+    lowRateIndex,
+    driveIndex,
+};
 
-    // add a parameter (AudioParameterFloat object) to the layout
-    // to make an AudioParameterFloat object you need 4 arguments
-        // a parameter ID (name and version hint)
-        // name of the parameter
-        // range of the parameter as a juce::NormalisableRange object
-        // default value
-    layout.add(std::make_unique<juce::AudioParameterFloat>(gainParamID,
-        "Output Gain", juce::NormalisableRange<float>{-12.0f, 12.0f}, 0.0f,
-        juce::AudioParameterFloatAttributes().withStringFromValueFunction(stringFromDecibels)));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(delayTimeParamID,
-        "Delay Time", juce::NormalisableRange<float>{minDelayTime, maxDelayTime, 0.001f, 0.25f}, 100.0f,
-        juce::AudioParameterFloatAttributes().withStringFromValueFunction(stringFromMilliseconds)
-        .withValueFromStringFunction (millisecondsFromString)));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(mixParamID, "Mix",
-        juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f), 100.0f,
-        juce::AudioParameterFloatAttributes().withStringFromValueFunction(stringFromPercent)));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(feedbackParamID, "Feedback",
-        juce::NormalisableRange<float>(-100.0f, 100.0f, 1.0f), 0.0f,
-        juce::AudioParameterFloatAttributes().withStringFromValueFunction(stringFromPercent)));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(stereoParamID,"Stereo",
-        juce::NormalisableRange<float>(-100.0f, 100.0f, 1.0f), 0.0f,
-        juce::AudioParameterFloatAttributes().withStringFromValueFunction (stringFromPercent)));
-    layout.add(std::make_unique<juce::AudioParameterFloat> (lowCutParamID, "Low Cut",
-        juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.3f), 20.0f,
-        juce::AudioParameterFloatAttributes().withStringFromValueFunction (stringFromHz)
-        .withValueFromStringFunction (hzFromString)));
-    layout.add(std::make_unique<juce::AudioParameterFloat> (highCutParamID, "High Cut",
-        juce::NormalisableRange<float>(0.0f, 20000.0f, 1.0f, 0.3f), 20000.0f,
-        juce::AudioParameterFloatAttributes().withStringFromValueFunction (stringFromHz)
-        .withValueFromStringFunction (hzFromString)));
-    layout.add(std::make_unique<juce::AudioParameterBool>(tempoSyncParamID, "Tempo Sync", false));
-    juce::StringArray noteLengths = {
+static_assert(std::size(floatParameters) == tempoSyncIndex);
+
+const juce::StringArray& noteLengths()
+{
+    // shared by all instances, only the first one builds it
+    static const juce::StringArray names = {
         "1/32",
         "1/16 trip",
         "1/32 dot",
@@ -139,8 +125,65 @@ juce::AudioProcessorValueTreeState::ParameterLayout Parameters::createParameterL
         "1/2 dot",
         "1/1",
     };
-    layout.add(std::make_unique<juce::AudioParameterChoice>(delayNoteParamID, "Delay Note", noteLengths, 9));
+    return names;
+}
+}
+
+// The layout adds the parameters in a known order, so each one is picked
+// out of the processor by index and static_cast, rather than looked up by
+// its ID string and dynamic_cast.
+template<typename T>
+static void castParameter(const juce::Array<juce::AudioProcessorParameter*>& parameters,
+                          int index, const juce::ParameterID& id, T& destination)
+{
+    destination = static_cast<T>(parameters[index]);
+    jassert(dynamic_cast<T>(parameters[index]) == destination);
+    jassert(destination->getParameterID() == id.getParamID());
+    juce::ignoreUnused(id);
+}
+
+// creates our Parameters object
+Parameters::Parameters(juce::AudioProcessorValueTreeState& apvts)
+{
+    const auto& parameters = apvts.processor.getParameters();
+    castParameter (parameters, gainIndex, gainParamID, gainParam);
+    castParameter (parameters, delayTimeIndex, delayTimeParamID, delayTimeParam);
+    castParameter (parameters, mixIndex, mixParamID, mixParam);
+    castParameter (parameters, feedbackIndex, feedbackParamID, feedbackParam);
+    castParameter (parameters, stereoIndex, stereoParamID, stereoParam);
+    castParameter (parameters, lowCutIndex, lowCutParamID, lowCutParam);
+    castParameter (parameters, highCutIndex, highCutParamID, highCutParam);
+    castParameter (parameters, tempoSyncIndex, tempoSyncParamID, tempoSyncParam);
+    castParameter (parameters, delayNoteIndex, delayNoteParamID, delayNoteParam);
+    castParameter (parameters, bypassIndex, bypassParamID, bypassParam);
+    castParameter (parameters, lowRateIndex, lowRateParamID, lowRateParam);
+    castParameter (parameters, driveIndex, driveParamID, driveParam);
+}
+
+// the function fills out the ParameterLayout object and returns it
+// the purpos of the ParameterLayout object is to describe the
+// parameter objects that should be added to the APVTS
+juce::AudioProcessorValueTreeState::ParameterLayout Parameters::createParameterLayout()
+{
+    // create the layout object
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    // the float parameters come from the table above
+    for (const auto& spec : floatParameters) {
+        layout.add(std::make_unique<juce::AudioParameterFloat>(*spec.id, spec.name,
+            juce::NormalisableRange<float>{spec.minimum, spec.maximum, spec.interval, spec.skew}, spec.defaultValue,
+            juce::AudioParameterFloatAttributes().withStringFromValueFunction(spec.stringFromValue)
+            .withValueFromStringFunction(spec.valueFromString)));
+    }
+    layout.add(std::make_unique<juce::AudioParameterBool>(tempoSyncParamID, "Tempo Sync", false));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(delayNoteParamID, "Delay Note", noteLengths(), 9));
     layout.add(std::make_unique<juce::AudioParameterBool>(bypassParamID, "Bypass", false));
+    // runs the delay and feedback at a lower sample rate when the high cut allows it
+    layout.add(std::make_unique<juce::AudioParameterBool>(lowRateParamID, "Low Rate Feedback", false));
+    // added last, so hosts that address parameters by index keep their automation
+    layout.add(std::make_unique<juce::AudioParameterFloat>(driveParamID, "Drive",
+        juce::NormalisableRange<float>{0.0f, 100.0f, 1.0f}, 0.0f,
+        juce::AudioParameterFloatAttributes().withStringFromValueFunction(stringFromPercent)));
     return layout;
 }
 
@@ -159,6 +202,8 @@ void Parameters::update() noexcept
     delayNote = delayNoteParam->getIndex();
     tempoSync = tempoSyncParam->get();
     bypassed = bypassParam->get();
+    lowRate = lowRateParam->get();
+    driveSmoother.setTargetValue(driveParam->get() * 0.01f);
 }
 
 void Parameters::prepareToPlay(double sampleRate) noexcept
@@ -171,6 +216,7 @@ void Parameters::prepareToPlay(double sampleRate) noexcept
     stereoSmoother.reset(sampleRate, duration);
     lowCutSmoother.reset(sampleRate, duration);
     highCutSmoother.reset(sampleRate, duration);
+    driveSmoother.reset(sampleRate, duration);
 }
 
 void Parameters::reset() noexcept
@@ -181,8 +227,8 @@ void Parameters::reset() noexcept
     feedback = 0.0f;
     panL = 0.0f;
     panR = 1.0f;
-    lowCut = 20.0f;
-    highCut = 20000.0f;
+    lowCut = lowCutParam->get();
+    highCut = highCutParam->get();
 
     gainSmoother.setCurrentAndTargetValue (juce::Decibels::decibelsToGain (gainParam->get()));
     mixSmoother.setCurrentAndTargetValue(mixParam->get() * 0.01f);
@@ -190,6 +236,8 @@ void Parameters::reset() noexcept
     stereoSmoother.setCurrentAndTargetValue(stereoParam->get() * 0.01f);
     lowCutSmoother.setCurrentAndTargetValue(lowCutParam->get());
     highCutSmoother.setCurrentAndTargetValue(highCutParam->get());
+    drive = driveParam->get() * 0.01f;
+    driveSmoother.setCurrentAndTargetValue(drive);
 }
 
 void Parameters::smoothen() noexcept
@@ -201,4 +249,5 @@ void Parameters::smoothen() noexcept
     panningEqualPower (stereoSmoother.getNextValue(), panL, panR);
     lowCut = lowCutSmoother.getNextValue();
     highCut = highCutSmoother.getNextValue();
+    drive = driveSmoother.getNextValue();
 }
@@ -13,6 +13,8 @@ const juce::ParameterID highCutParamID{"highCut", 1};
 const juce::ParameterID tempoSyncParamID { "tempoSync", 1 };
 const juce::ParameterID delayNoteParamID{ "delayNote", 1 };
 const juce::ParameterID bypassParamID{ "bypass", 1 };
+const juce::ParameterID lowRateParamID{ "lowRate", 1 };
+const juce::ParameterID driveParamID{ "drive", 1 };
 
 class Parameters{
 public:
@@ -36,12 +38,15 @@ public:
     int delayNote = 0;
     bool tempoSync = false;
     bool bypassed = false;
+    bool lowRate = false;
+    float drive = 0.0f;  // saturation in the feedback path, 0 to 1, off at 0
 
     static constexpr float minDelayTime = 5.0f;
     static constexpr float maxDelayTime = 5000.0f;
 
     juce::AudioParameterBool* tempoSyncParam;
     juce::AudioParameterBool* bypassParam;
+    juce::AudioParameterBool* lowRateParam;
 private:
     juce::LinearSmoothedValue<float> gainSmoother;
     juce::AudioParameterFloat* gainParam;
@@ -59,4 +64,6 @@ private:
     juce::AudioParameterFloat* highCutParam;
     juce::LinearSmoothedValue<float> highCutSmoother;
     juce::AudioParameterChoice* delayNoteParam;
+    juce::AudioParameterFloat* driveParam;
+    juce::LinearSmoothedValue<float> driveSmoother;
 };
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include "PluginEditor.h"
 
 PluginEditor::PluginEditor (PluginProcessor& p)
-    : AudioProcessorEditor (&p), processorRef (p), meter(p.levelL, p.levelR)
+    : AudioProcessorEditor (&p), processorRef (p), meter(p.meters.levelL, p.meters.levelR),
+      scope(p.scopeBuffer), spectrum(p.spectrum),
+      loudness(p.loudness)
 {
     juce::ignoreUnused (processorRef);
 
@@ -23,6 +25,7 @@ PluginEditor::PluginEditor (PluginProcessor& p)
     feedbackGroup.addAndMakeVisible (stereoKnob);
     feedbackGroup.addAndMakeVisible (lowCutKnob);
     feedbackGroup.addAndMakeVisible (highCutKnob);
+    feedbackGroup.addAndMakeVisible (driveKnob);
     addAndMakeVisible (feedbackGroup);
 
     outputGroup.setText("Output");
@@ -32,7 +35,7 @@ PluginEditor::PluginEditor (PluginProcessor& p)
     outputGroup.addAndMakeVisible (meter);
     addAndMakeVisible (outputGroup);
 
-    auto bypassIcon = juce::ImageCache::getFromMemory (BinaryData::Bypass_png, BinaryData::Bypass_pngSize);
+    auto bypassIcon = assets->getBypassIcon();
     bypassButton.setClickingTogglesState (true);
     bypassButton.setBounds (0,0,20,20);
     bypassButton.setImages (
@@ -42,6 +45,9 @@ PluginEditor::PluginEditor (PluginProcessor& p)
         bypassIcon, 1.0f, juce::Colours::grey,
         0.0f);
     addAndMakeVisible (bypassButton);
+    addAndMakeVisible (scope);
+    addAndMakeVisible (spectrum);
+    addAndMakeVisible (loudness);
 
 
     // addAndMakeVisible (inspectButton);
@@ -57,25 +63,32 @@ PluginEditor::PluginEditor (PluginProcessor& p)
     //     inspector->setVisible (true);
     // };
 
+    setOpaque (true);
     setLookAndFeel (&mainLF);
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (500, 330);
+    setSize (590, 400);
     updateDelayKnobs(processorRef.params.tempoSyncParam->get());
-    processorRef.params.tempoSyncParam->addListener (this);
 }
 
 PluginEditor::~PluginEditor()
 {
-    processorRef.params.tempoSyncParam->removeListener (this);
     setLookAndFeel (nullptr);
 }
 
 void PluginEditor::paint (juce::Graphics& g)
 {
-    auto noise = juce::ImageCache::getFromMemory(
-    BinaryData::Noise_png, BinaryData::Noise_pngSize);
-    auto fillType = juce::FillType(noise, juce::AffineTransform::scale(0.5f));
+    // the background never changes, so it is drawn once per size and
+    // display scale and then copied, by this editor and any opened later
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    auto background = assets->getBackground(getWidth(), getHeight(), scale,
+                                            [this](juce::Graphics& bg) { drawBackground(bg); });
+    g.drawImage(background, getLocalBounds().toFloat());
+}
+
+void PluginEditor::drawBackground (juce::Graphics& g)
+{
+    auto fillType = juce::FillType(assets->getNoise(), juce::AffineTransform::scale(0.5f));
     g.setFillType(fillType);
     g.fillRect(getLocalBounds());
 
@@ -83,8 +96,7 @@ void PluginEditor::paint (juce::Graphics& g)
     g.setColour(Colors::header);
     g.fillRect(rect);
 
-    auto image = juce::ImageCache::getFromMemory(
-        BinaryData::Logo_png, BinaryData::Logo_pngSize);
+    auto image = assets->getLogo();
 
     int destWidth = image.getWidth() / 2;
     int destHeight = image.getHeight() / 2;
@@ -98,7 +110,8 @@ void PluginEditor::resized()
     auto bounds = getLocalBounds();
 
     int y = 50;
-    int height = bounds.getHeight()-60;
+    int scopeHeight = 60;
+    int height = bounds.getHeight()-70-scopeHeight;
 
     delayGroup.setBounds (10, y, 110, height);
     outputGroup.setBounds(bounds.getWidth() - 160, y, 150, height);
@@ -114,27 +127,42 @@ void PluginEditor::resized()
     stereoKnob.setTopLeftPosition (feedbackKnob.getRight()+20, 20);
     lowCutKnob.setTopLeftPosition (feedbackKnob.getX(), feedbackKnob.getBottom()+10);
     highCutKnob.setTopLeftPosition (lowCutKnob.getRight()+20, lowCutKnob.getY());
+    driveKnob.setTopLeftPosition (stereoKnob.getRight()+20, 20);
     meter.setBounds (outputGroup.getWidth() - 45, 30, 30, gainKnob.getBottom() - 30);
     bypassButton.setTopLeftPosition (bounds.getRight() - bypassButton.getWidth() - 10, 10);
+    int halfWidth = (bounds.getWidth() - 30) / 2;
+    scope.setBounds (10, bounds.getBottom() - scopeHeight - 10, halfWidth, scopeHeight);
+    spectrum.setBounds (scope.getRight() + 10, scope.getY(), halfWidth, scopeHeight);
+    loudness.setBounds (10, 10, 170, 20);  // left of the logo in the header
     // layout the positions of your child components here
     // auto area = getLocalBounds();
     // area.removeFromBottom(50);
     // inspectButton.setBounds (getLocalBounds().withSizeKeepingCentre(100, 50));
 }
 
-void PluginEditor::parameterValueChanged (int, float value)
+void PluginEditor::updateFrame()
 {
-    if (juce::MessageManager::getInstance()->isThisTheMessageThread()) {
-        updateDelayKnobs (value != 0.0f);
-    } else {
-        juce::MessageManager::callAsync([this, value] {
-            updateDelayKnobs (value != 0.0f);
-        });
+    for (auto* knob : { &gainKnob, &mixKnob, &delayTimeKnob, &feedbackKnob, &stereoKnob,
+                        &lowCutKnob, &highCutKnob, &driveKnob, &delayNoteKnob }) {
+        knob->attachment.update();
     }
+    tempoSyncAttachment.update();
+    bypassAttachment.update();
+
+    bool tempoSyncActive = processorRef.params.tempoSyncParam->get();
+    if (tempoSyncActive != tempoSyncShown) {
+        updateDelayKnobs (tempoSyncActive);
+    }
+
+    meter.update();
+    scope.update();
+    spectrum.update();
+    loudness.update();
 }
 
 void PluginEditor::updateDelayKnobs (bool tempoSyncActive)
 {
+    tempoSyncShown = tempoSyncActive;
     delayTimeKnob.setVisible(!tempoSyncActive);
     delayNoteKnob.setVisible(tempoSyncActive);
 }
@@ -7,10 +7,13 @@
 #include "RotaryKnob.h"
 #include "LookAndFeel.h"
 #include "LevelMeter.h"
+#include "ScopeView.h"
+#include "SpectrumView.h"
+#include "LoudnessDisplay.h"
+#include "AssetCache.h"
 
 //==============================================================================
-class PluginEditor : public juce::AudioProcessorEditor,
-private juce::AudioProcessorParameter::Listener
+class PluginEditor : public juce::AudioProcessorEditor
 {
 public:
     explicit PluginEditor (PluginProcessor&);
@@ -21,11 +24,12 @@ public:
     void resized() override;
 
 private:
-    void parameterValueChanged(int, float) override;
-    void parameterGestureChanged(int, bool) override{}
     void updateDelayKnobs(bool tempoSyncActive);
+    void drawBackground(juce::Graphics& g);
+    void updateFrame();
     PluginProcessor& processorRef;
     MainLookAndFeel mainLF;
+    juce::SharedResourcePointer<AssetCache> assets;  // shared with the other editors
 
     RotaryKnob gainKnob {"Gain", processorRef.apvts, gainParamID, true};
     RotaryKnob mixKnob {"Mix", processorRef.apvts, mixParamID};
@@ -34,18 +38,24 @@ private:
     RotaryKnob stereoKnob {"Stereo", processorRef.apvts, stereoParamID, true};
     RotaryKnob lowCutKnob {"Low Cut", processorRef.apvts, lowCutParamID};
     RotaryKnob highCutKnob {"High Cut", processorRef.apvts, highCutParamID};
+    RotaryKnob driveKnob {"Drive", processorRef.apvts, driveParamID};
     RotaryKnob delayNoteKnob {"Note", processorRef.apvts, delayNoteParamID};
     juce::TextButton tempoSyncButton;
-    juce::AudioProcessorValueTreeState::ButtonAttachment tempoSyncAttachment {
-        processorRef.apvts, tempoSyncParamID.getParamID(), tempoSyncButton
-    };
+    PolledButtonAttachment tempoSyncAttachment { *processorRef.params.tempoSyncParam, tempoSyncButton };
+    bool tempoSyncShown = false;
     juce::GroupComponent delayGroup, feedbackGroup, outputGroup;
 
     LevelMeter meter;
+    ScopeView scope;
+    SpectrumView spectrum;
+    LoudnessDisplay loudness;
     juce::ImageButton bypassButton;
-    juce::AudioProcessorValueTreeState::ButtonAttachment bypassAttachment {
-        processorRef.apvts, bypassParamID.getParamID(),bypassButton
-    };
+    PolledButtonAttachment bypassAttachment { *processorRef.params.bypassParam, bypassButton };
+
+    // One callback per display frame for the meters and the controls, only
+    // while the editor is on screen. The controls follow their parameters
+    // from here rather than through listeners.
+    juce::VBlankAttachment vblankAttachment { this, [this] { updateFrame(); } };
 
     std::unique_ptr<melatonin::Inspector> inspector;
     juce::TextButton inspectButton { "Inspect the UI" };
@@ -1,6 +1,5 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
-#include "ProtectYourEars.h"
 
 //==============================================================================
 PluginProcessor::PluginProcessor()
@@ -10,12 +9,12 @@ PluginProcessor::PluginProcessor()
             .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
         ), params(apvts)
 {
-    lowCutFilter.setType (juce::dsp::StateVariableTPTFilterType::highpass);
-    highCutFilter.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
+    backgroundThread->addTimeSliceClient (this);
 }
 
 PluginProcessor::~PluginProcessor()
 {
+    backgroundThread->removeTimeSliceClient (this);
 }
 
 //==============================================================================
@@ -89,10 +88,11 @@ void PluginProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
     juce::ignoreUnused (sampleRate, samplesPerBlock);
+    TRACE_REGISTER_THREAD();  // so processBlock's first zone doesn't allocate
+    TRACE_SCOPE ("prepareToPlay");
     params.prepareToPlay (sampleRate);
     params.reset();
-    feedbackL = 0.0f;
-    feedbackR = 0.0f;
+    params.update();
     lastLowCut = -1.0f;
     lastHighCut = -1.0f;
     /*
@@ -112,24 +112,40 @@ void PluginProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
     wait = 0.0f;
     waitInc = 1.0f / (0.3f * float(sampleRate));  // 300 ms
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = juce::uint32(samplesPerBlock);
-    spec.numChannels = 2;
-    double numSamples = Parameters::maxDelayTime/1000.0 * sampleRate;
+    tempo.prepare(sampleRate);
+    wasTempoSync = params.tempoSync;
+    lastDelayNote = params.delayNote;
+
+    // Only allocate for the delay time that is currently dialled in, with
+    // room to move. If it goes up later, the delay lines are grown in the
+    // background while the audio is running. They are sized for the host
+    // rate even when the loop runs at a lower one, so that switching back
+    // never has to wait for memory.
+    float delayTime = params.tempoSync ? float(tempo.getMillisecondsForNoteLength (params.delayNote)) : params.delayTime;
+    float allocatedTime = std::clamp(delayTime * 2.0f, minAllocatedDelayTime, Parameters::maxDelayTime);
+    double numSamples = allocatedTime/1000.0 * sampleRate;
     int maxDelayInSamples = int(std::ceil(numSamples));
-    delayLineL.setMaximumDelayInSamples(maxDelayInSamples);
-    delayLineR.setMaximumDelayInSamples(maxDelayInSamples);
-    delayLineL.reset();
-    delayLineR.reset();
-    lowCutFilter.prepare(spec);
-    lowCutFilter.reset();
-    highCutFilter.prepare(spec);
-    highCutFilter.reset();
-    tempo.reset();
-    levelL.reset();
-    levelR.reset();
-    // DBG(maxDelayInSamples);
+    // only the path the host is going to call gets the memory
+    auto allocate = [&] (auto& state) {
+        TRACE_SCOPE ("delay line allocation");
+        state.delayLineL.setMaximumDelayInSamples(maxDelayInSamples);
+        state.delayLineR.setMaximumDelayInSamples(maxDelayInSamples);
+        state.wetBuffer.setSize(2, samplesPerBlock);
+    };
+    if (isUsingDoublePrecision()) {
+        allocate(doubleState);
+    } else {
+        allocate(floatState);
+    }
+    kernels = &Kernels::select();
+    outputGuard.reset();
+    scopeBuffer.prepare (sampleRate);
+    loudness.prepare (sampleRate);
+    diagnostics.push ("prepared, delay lines hold %g samples", float(maxDelayInSamples));
+    targetDecimation = params.lowRate ? decimationForHighCut (params.highCut, float(sampleRate)) : 1;
+    setDecimation (targetDecimation, float(sampleRate));
+    meters.levelL.reset();
+    meters.levelR.reset();
 }
 
 void PluginProcessor::releaseResources()
@@ -155,6 +171,36 @@ void PluginProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[maybe_un
                                               juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused (midiMessages);
+    processSamples (buffer, floatState);
+}
+
+void PluginProcessor::processBlock (juce::AudioBuffer<double>& buffer, [[maybe_unused]]
+                                              juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused (midiMessages);
+    processSamples (buffer, doubleState);
+}
+
+bool PluginProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+// The body of both processBlock overloads. Everything that holds samples
+// comes from the state for this sample type; the parameters, smoothing and
+// ducking are shared and stay in float.
+template <typename SampleType>
+void PluginProcessor::processSamples (juce::AudioBuffer<SampleType>& buffer, DelayState<SampleType>& state) noexcept
+{
+    TRACE_SCOPE ("processBlock");
+
+    // prepareToPlay only allocates for the precision the host said it would use
+    if (state.wetBuffer.getNumChannels() == 0) {
+        jassertfalse;
+        return;
+    }
+    auto& [delayLineL, delayLineR, wetBuffer, feedbackFilter, saturator, decimator, interpolatorL, interpolatorR,
+           feedbackL, feedbackR] = state;
 
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
@@ -164,33 +210,84 @@ void PluginProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[maybe_un
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    params.update();
-    tempo.update(getPlayHead());
-
-    float syncedTime = float(tempo.getMillisecondsForNoteLength (params.delayNote));
-    if (syncedTime > Parameters::maxDelayTime) {
-        syncedTime = Parameters::maxDelayTime;
+    {
+        TRACE_SCOPE ("parameter update");
+        params.update();
+    }
+    {
+        TRACE_SCOPE ("tempo query");
+        tempo.update(getPlayHead(), buffer.getNumSamples());
     }
 
     float sampleRate = float(getSampleRate());
 
+    // The synced length comes cached from Tempo and only moves when the
+    // tempo really changes. If that is all that changed, the delay glides
+    // over to it instead of ducking, so a tempo ramp keeps its echoes.
+    float syncedDelay = std::min(float(tempo.getSamplesForNoteLength (params.delayNote)),
+                                 Parameters::maxDelayTime / 1000.0f * sampleRate);
+    bool followTempo = params.tempoSync && wasTempoSync && params.delayNote == lastDelayNote;
+    wasTempoSync = params.tempoSync;
+    lastDelayNote = params.delayNote;
+
+    delayLineL.swapInRequestedBuffer();
+    delayLineR.swapInRequestedBuffer();
+    float maxDelayInSamples = float(std::min(delayLineL.getMaximumDelayInSamples(),
+                                             delayLineR.getMaximumDelayInSamples()));
+
+    // A change in decimation is handled like a change in delay time: fade
+    // out, wait, switch over and fade back in.
+    int newDecimation = params.lowRate ? decimationForHighCut (params.highCut, sampleRate) : 1;
+    if (newDecimation != targetDecimation) {
+        targetDecimation = newDecimation;
+        wait = waitInc;
+        fadeTarget = 0.0f;
+    }
+
+    // only while an editor is showing the spectrum
+    bool analysing = spectrum.isActive();
+
     auto mainInput = getBusBuffer(buffer, true, 0);
     auto mainInputChannels = mainInput.getNumChannels();
     auto isMainInputStereo = mainInputChannels > 1;
-    const float* inputDataL = mainInput.getReadPointer(0);
-    const float* inputDataR = mainInput.getReadPointer(isMainInputStereo ? 1 : 0);
+    const SampleType* inputDataL = mainInput.getReadPointer(0);
+    const SampleType* inputDataR = mainInput.getReadPointer(isMainInputStereo ? 1 : 0);
 
     auto mainOutput = getBusBuffer(buffer, false, 0);
     auto mainOutputChannels = mainOutput.getNumChannels();
     auto isMainOutputStereo = mainOutputChannels > 1;
-    float* outputDataL = mainOutput.getWritePointer(0);
-    float* outputDataR = mainOutput.getWritePointer(isMainOutputStereo ? 1 : 0);
-
-    float maxL = 0.0f;
-    float maxR = 0.0f;
+    SampleType* outputDataL = mainOutput.getWritePointer(0);
+    SampleType* outputDataR = mainOutput.getWritePointer(isMainOutputStereo ? 1 : 0);
+
+    // While the delay sits on a whole number of samples and is at least a
+    // block long, the wet signal for the whole block is already in the ring
+    // and can be copied out up front without interpolating. This stays valid
+    // until the ducking logic below moves delayInSamples.
+    typename BasicDelayLine<SampleType>::ReadRegions regionsL, regionsR;
+    bool readFromRegions = decimation == 1
+        && delayInSamples >= float(buffer.getNumSamples())
+        && delayInSamples == std::floor(delayInSamples)
+        && buffer.getNumSamples() <= wetBuffer.getNumSamples()
+        && delayLineL.getReadRegions(int(delayInSamples), buffer.getNumSamples(), regionsL)
+        && delayLineR.getReadRegions(int(delayInSamples), buffer.getNumSamples(), regionsR);
+    const SampleType* wetDataL = wetBuffer.getReadPointer(0);
+    const SampleType* wetDataR = wetBuffer.getReadPointer(1);
+    if (readFromRegions) {
+        TRACE_SCOPE ("delay read, whole block");
+        if constexpr (std::is_same_v<SampleType, float>) {
+            regionsL.copyTo(wetBuffer.getWritePointer(0), kernels->decode);
+            regionsR.copyTo(wetBuffer.getWritePointer(1), kernels->decode);
+        } else {
+            regionsL.copyTo(wetBuffer.getWritePointer(0));
+            regionsR.copyTo(wetBuffer.getWritePointer(1));
+        }
+    }
 
     if (isMainOutputStereo)
     {
+        // The delay reads and writes and the filters are interleaved sample
+        // by sample through the feedback, so they are timed as one zone.
+        TRACE_SCOPE ("delay, feedback and mix, stereo");
         for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
         {
             params.smoothen();
@@ -213,87 +310,142 @@ void PluginProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[maybe_un
             */
 
             // For ducking:
-            float delayTime = params.tempoSync ? syncedTime : params.delayTime;
-            float newTargetDelay = delayTime / 1000.0f * sampleRate;
+            float newTargetDelay = params.tempoSync ? syncedDelay : params.delayTime / 1000.0f * sampleRate;
             if (newTargetDelay != targetDelay) {
                 targetDelay = newTargetDelay;
+                delayLineL.requestMaximumDelayInSamples (int(std::ceil(targetDelay)));
+                delayLineR.requestMaximumDelayInSamples (int(std::ceil(targetDelay)));
                 if (delayInSamples == 0.0f) {  // first time
-                    delayInSamples = targetDelay;
-                } else {
+                    delayInSamples = std::min(targetDelay, maxDelayInSamples);
+                }
+                bool glide = followTempo && wait == 0.0f && targetDelay <= maxDelayInSamples
+                    && std::abs(targetDelay - delayInSamples) <= maxTempoGlide * delayInSamples;
+                if (delayInSamples != targetDelay && !glide) {
                     wait = waitInc;     // start counter
                     fadeTarget = 0.0f;  // fade out
                 }
             }
 
+            // the filters run at the low rate and must stay below its Nyquist
+            float maxCutoff = 0.45f * sampleRate / float(decimation);
             if (params.lowCut != lastLowCut) {
-                lowCutFilter.setCutoffFrequency (params.lowCut);
+                feedbackFilter.setLowCut (std::min(params.lowCut, maxCutoff));
                 lastLowCut = params.lowCut;
             }
             if (params.highCut != lastHighCut) {
-                highCutFilter.setCutoffFrequency (params.highCut);
+                feedbackFilter.setHighCut (std::min(params.highCut, maxCutoff));
                 lastHighCut = params.highCut;
             }
 
-            float dryL = inputDataL[sample];
-            float dryR = inputDataR[sample];
+            SampleType dryL = inputDataL[sample];
+            SampleType dryR = inputDataR[sample];
 
-            float mono  = (dryL + dryR) * 0.5f;
+            SampleType mono  = (dryL + dryR) * SampleType(0.5);
 
-            delayLineL.write (mono*params.panL + feedbackR);
-            delayLineR.write (mono*params.panR + feedbackL);
+            // For ducking:
+            fade += (fadeTarget - fade) * coeff;
 
-            float wetL = delayLineL.read (delayInSamples);
-            float wetR = delayLineR.read (delayInSamples);
+            SampleType wetL, wetR;
+            if (decimation == 1) {
+                delayLineL.write (mono*params.panL + feedbackR);
+                delayLineR.write (mono*params.panR + feedbackL);
 
-            /*
-            // For crossfading:
-            if (xfade > 0.0f) {  // crossfading?
-                float newL = delayLineL.read(targetDelay);
-                float newR = delayLineR.read(targetDelay);
+                wetL = readFromRegions ? wetDataL[sample] : delayLineL.read (delayInSamples);
+                wetR = readFromRegions ? wetDataR[sample] : delayLineR.read (delayInSamples);
 
-                wetL = (1.0f - xfade) * wetL + xfade * newL;
-                wetR = (1.0f - xfade) * wetR + xfade * newR;
+                /*
+                // For crossfading:
+                if (xfade > 0.0f) {  // crossfading?
+                    float newL = delayLineL.read(targetDelay);
+                    float newR = delayLineR.read(targetDelay);
 
-                xfade += xfadeInc;
-                if (xfade >= 1.0f) {
-                    delayInSamples = targetDelay;
-                    xfade = 0.0f;
+                    wetL = (1.0f - xfade) * wetL + xfade * newL;
+                    wetR = (1.0f - xfade) * wetR + xfade * newR;
+
+                    xfade += xfadeInc;
+                    if (xfade >= 1.0f) {
+                        delayInSamples = targetDelay;
+                        xfade = 0.0f;
+                    }
                 }
-            }
-            */
+                */
 
-            // For ducking:
-            fade += (fadeTarget - fade) * coeff;
+                wetL *= fade;
+                wetR *= fade;
 
-            wetL *= fade;
-            wetR *= fade;
+                // multi-tap delay
+                // wetL += delayLine.popSample(0, delayInSamples*2.0f, false) * 0.7f;
+                // wetR += delayLine.popSample(0, delayInSamples*2.0f, false) * 0.7f;
+
+                feedbackL = wetL * params.feedback;
+                feedbackR = wetR * params.feedback;
+                feedbackFilter.process (feedbackL, feedbackR);
+                if (params.drive > 0.0f) {
+                    saturator.process (feedbackL, feedbackR, SampleType(params.drive));
+                }
+                if (analysing) {
+                    spectrum.push (float((feedbackL + feedbackR) * SampleType(0.5)));
+                }
+            } else {
+                // The same loop at the low rate, once every `decimation`
+                // samples. The wet signal comes back up through the
+                // interpolators.
+                SampleType monoLow;
+                if (decimator.process (mono, monoLow)) {
+                    delayLineL.write (monoLow*params.panL + feedbackR);
+                    delayLineR.write (monoLow*params.panR + feedbackL);
+
+                    // Read at the low rate, the feedback goes back in a whole
+                    // low rate sample later instead of one host sample, and
+                    // the wet signal is held up by the resamplers' latency.
+                    // Both are read that much earlier, so the echoes land
+                    // where they do at the full rate.
+                    float lowDelay = delayInSamples / float(decimation);
+                    float feedbackDelay = std::max(lowDelay - float(decimation - 1) / float(decimation), 1.0f);
+                    float wetDelay = std::max(lowDelay - float(Resampling::getLatency(decimation)) / float(decimation), 1.0f);
+                    SampleType lowL = delayLineL.read (feedbackDelay) * fade;
+                    SampleType lowR = delayLineR.read (feedbackDelay) * fade;
+
+                    feedbackL = lowL * params.feedback;
+                    feedbackR = lowR * params.feedback;
+                    feedbackFilter.process (feedbackL, feedbackR);
+                    if (params.drive > 0.0f) {
+                        saturator.process (feedbackL, feedbackR, SampleType(params.drive));
+                    }
+                    if (analysing) {
+                        spectrum.push (float((feedbackL + feedbackR) * SampleType(0.5)));
+                    }
+
+                    interpolatorL.push (delayLineL.read (wetDelay) * fade);
+                    interpolatorR.push (delayLineR.read (wetDelay) * fade);
+                }
+                wetL = interpolatorL.process();
+                wetR = interpolatorR.process();
+            }
 
             if (wait > 0.0f) {
                 wait += waitInc;
-                if (wait >= 1.0f) {
+                // stay silent until the delay lines have grown large enough
+                if (wait >= 1.0f && targetDelay <= maxDelayInSamples) {
                     delayInSamples = targetDelay;
+                    readFromRegions = false;
+                    if (decimation != targetDecimation) {
+                        setDecimation (targetDecimation, sampleRate);
+                    }
                     wait = 0.0f;
                     fadeTarget = 1.0f;  // fade in
                 }
+            } else if (delayInSamples != targetDelay) {
+                // gliding after a small tempo change
+                glideTowardsTarget();
+                readFromRegions = false;
             }
 
-            // multi-tap delay
-            // wetL += delayLine.popSample(0, delayInSamples*2.0f, false) * 0.7f;
-            // wetR += delayLine.popSample(0, delayInSamples*2.0f, false) * 0.7f;
+            SampleType mixL = dryL + wetL * params.mix;
+            SampleType mixR = dryR + wetR * params.mix;
 
-            feedbackL = wetL * params.feedback;
-            feedbackL = lowCutFilter.processSample (0, feedbackL);
-            feedbackL = highCutFilter.processSample (0, feedbackL);
-            feedbackR = wetR * params.feedback;
-            feedbackR = lowCutFilter.processSample (1, feedbackR);
-            feedbackR = highCutFilter.processSample (1, feedbackR);
-
-
-            float mixL = dryL + wetL * params.mix;
-            float mixR = dryR + wetR * params.mix;
-
-            float outL = mixL * params.gain;
-            float outR = mixR * params.gain;
+            SampleType outL = mixL * params.gain;
+            SampleType outR = mixR * params.gain;
             if (params.bypassed)
             {
                 outL = dryL;
@@ -301,10 +453,10 @@ void PluginProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[maybe_un
             }
             outputDataL[sample] = outL;
             outputDataR[sample] = outR;
-            maxL = std::max(maxL, std::abs(outL));
-            maxR = std::max(maxR, std::abs(outR));
+            scopeBuffer.push (float(mono), float((wetL + wetR) * SampleType(0.5)));
         }
     } else {
+        TRACE_SCOPE ("delay, feedback and mix, mono");
         for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
         {
             params.smoothen();
@@ -326,31 +478,43 @@ void PluginProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[maybe_un
             }
             */
             // For ducking:
-            float delayTime = params.tempoSync ? syncedTime : params.delayTime;
-            float newTargetDelay = delayTime / 1000.0f * sampleRate;
+            float newTargetDelay = params.tempoSync ? syncedDelay : params.delayTime / 1000.0f * sampleRate;
             if (newTargetDelay != targetDelay) {
                 targetDelay = newTargetDelay;
+                delayLineL.requestMaximumDelayInSamples (int(std::ceil(targetDelay)));
+                delayLineR.requestMaximumDelayInSamples (int(std::ceil(targetDelay)));
                 if (delayInSamples == 0.0f) {  // first time
-                    delayInSamples = targetDelay;
-                } else {
+                    delayInSamples = std::min(targetDelay, maxDelayInSamples);
+                }
+                bool glide = followTempo && wait == 0.0f && targetDelay <= maxDelayInSamples
+                    && std::abs(targetDelay - delayInSamples) <= maxTempoGlide * delayInSamples;
+                if (delayInSamples != targetDelay && !glide) {
                     wait = waitInc;     // start counter
                     fadeTarget = 0.0f;  // fade out
                 }
             }
 
+            // the filters run at the low rate and must stay below its Nyquist
+            float maxCutoff = 0.45f * sampleRate / float(decimation);
             if (params.lowCut != lastLowCut) {
-                lowCutFilter.setCutoffFrequency (params.lowCut);
+                feedbackFilter.setLowCut (std::min(params.lowCut, maxCutoff));
                 lastLowCut = params.lowCut;
             }
             if (params.highCut != lastHighCut) {
-                highCutFilter.setCutoffFrequency (params.highCut);
+                feedbackFilter.setHighCut (std::min(params.highCut, maxCutoff));
                 lastHighCut = params.highCut;
             }
 
-            float dry = inputDataL[sample];
-            delayLineL.write (dry + feedbackL);
+            SampleType dry = inputDataL[sample];
 
-            float wet = delayLineL.read (delayInSamples);        /*
+            // For ducking:
+            fade += (fadeTarget - fade) * coeff;
+
+            SampleType wet;
+            if (decimation == 1) {
+                delayLineL.write (dry + feedbackL);
+
+                wet = readFromRegions ? wetDataL[sample] : delayLineL.read (delayInSamples);        /*
         // For crossfading:
         if (xfade > 0.0f) {  // crossfading?
             float newL = delayLineL.read(targetDelay);
@@ -367,40 +531,185 @@ void PluginProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[maybe_un
         }
         */
 
-            // For ducking:
-            fade += (fadeTarget - fade) * coeff;
+                wet *= fade;
 
-            wet *= fade;
+                feedbackL = wet * params.feedback;
+                feedbackR = 0.0f;  // the right lane is unused in mono
+                feedbackFilter.process (feedbackL, feedbackR);
+                if (params.drive > 0.0f) {
+                    saturator.process (feedbackL, feedbackR, SampleType(params.drive));
+                }
+                if (analysing) {
+                    spectrum.push (float(feedbackL));
+                }
+            } else {
+                SampleType dryLow;
+                if (decimator.process (dry, dryLow)) {
+                    delayLineL.write (dryLow + feedbackL);
+
+                    // read earlier to make up for the low rate, as in stereo
+                    float lowDelay = delayInSamples / float(decimation);
+                    float feedbackDelay = std::max(lowDelay - float(decimation - 1) / float(decimation), 1.0f);
+                    float wetDelay = std::max(lowDelay - float(Resampling::getLatency(decimation)) / float(decimation), 1.0f);
+                    SampleType wetLow = delayLineL.read (feedbackDelay) * fade;
+
+                    feedbackL = wetLow * params.feedback;
+                    feedbackR = 0.0f;  // the right lane is unused in mono
+                    feedbackFilter.process (feedbackL, feedbackR);
+                    if (params.drive > 0.0f) {
+                        saturator.process (feedbackL, feedbackR, SampleType(params.drive));
+                    }
+                    if (analysing) {
+                        spectrum.push (float(feedbackL));
+                    }
+
+                    interpolatorL.push (delayLineL.read (wetDelay) * fade);
+                }
+                wet = interpolatorL.process();
+            }
 
             if (wait > 0.0f) {
                 wait += waitInc;
-                if (wait >= 1.0f) {
+                // stay silent until the delay lines have grown large enough
+                if (wait >= 1.0f && targetDelay <= maxDelayInSamples) {
                     delayInSamples = targetDelay;
+                    readFromRegions = false;
+                    if (decimation != targetDecimation) {
+                        setDecimation (targetDecimation, sampleRate);
+                    }
                     wait = 0.0f;
                     fadeTarget = 1.0f;  // fade in
                 }
+            } else if (delayInSamples != targetDelay) {
+                // gliding after a small tempo change
+                glideTowardsTarget();
+                readFromRegions = false;
             }
 
-            feedbackL = wet * params.feedback;
-            feedbackL = lowCutFilter.processSample (0, feedbackL);
-            feedbackL = highCutFilter.processSample (0, feedbackL);
-
-            float mix = dry + wet * params.mix;
+            SampleType mix = dry + wet * params.mix;
             outputDataL[sample] = mix * params.gain;
-            float outL = mix * params.gain;
+            SampleType outL = mix * params.gain;
             if (params.bypassed)
             {
                 outL = dry;
             }
             outputDataL[sample] = outL;
-            maxL = std::max(maxL, std::abs(outL));
+            scopeBuffer.push (float(dry), float(wet));
+        }
+    }
+    if (analysing) {
+        spectrum.flush();
+    }
+
+    TRACE_SCOPE ("metering and output guard");
+    auto peakBits = [this] (const SampleType* data, int numSamples) {
+        if constexpr (std::is_same_v<SampleType, float>) {
+            return kernels->peakBits (data, numSamples);
+        } else {
+            return kernels->peakBitsDouble (data, numSamples);
+        }
+    };
+    uint32_t peakBitsL = peakBits (outputDataL, buffer.getNumSamples());
+    uint32_t peakBitsR = isMainOutputStereo ? peakBits (outputDataR, buffer.getNumSamples()) : 0;
+    float guardGain = 1.0f;
+    if (params.bypassed) {
+        // the dry signal goes out exactly as it came in
+        outputGuard.reset();
+    } else if (outputGuard.process (buffer, std::max(peakBitsL, peakBitsR))) {
+        diagnostics.push ("output silenced, peak %g", std::bit_cast<float>(std::max(peakBitsL, peakBitsR)));
+        // whatever blew up is still in the feedback loop
+        clearFeedbackLoop();
+        peakBitsL = 0;
+        peakBitsR = 0;
+    } else {
+        guardGain = outputGuard.getGain();
+    }
+    meters.levelL.updateIfGreater (std::bit_cast<float>(peakBitsL) * guardGain);
+    meters.levelR.updateIfGreater (std::bit_cast<float>(peakBitsR) * guardGain);
+    loudness.push (outputDataL, isMainOutputStereo ? outputDataR : nullptr, buffer.getNumSamples());
+}
+
+// The largest factor that keeps the high cut below half of the Nyquist
+// frequency at the low rate. Going to a larger factor needs a bit of extra
+// room, so a high cut sitting right on the edge doesn't flip back and forth.
+int PluginProcessor::decimationForHighCut (float highCut, float sampleRate) const noexcept
+{
+    int factor = Resampling::maxFactor;
+    while (factor > 1) {
+        float limit = 0.25f * sampleRate / float(factor);
+        if (factor > decimation) {
+            limit *= 0.9f;
+        }
+        if (highCut <= limit) {
+            break;
         }
+        factor /= 2;
+    }
+    return factor;
+}
+
+// Switches the delay loop over to a new rate. The delay lines and filters
+// hold state at the old rate, so they start over.
+void PluginProcessor::setDecimation (int factor, float sampleRate) noexcept
+{
+    diagnostics.push ("running the delay loop at 1/%g of %g Hz", float(factor), sampleRate);
+    decimation = factor;
+    auto update = [&] (auto& state) {
+        state.decimator.setFactor (factor);
+        state.interpolatorL.setFactor (factor);
+        state.interpolatorR.setFactor (factor);
+        state.feedbackFilter.prepare(double(sampleRate) / factor);
+    };
+    update(floatState);
+    update(doubleState);
+    spectrum.setSampleRate(double(sampleRate) / factor);
+    lastLowCut = -1.0f;
+    lastHighCut = -1.0f;
+    clearFeedbackLoop();
+}
+
+// Moves the delay one step of glideRate towards targetDelay. The position
+// is kept in double: from 2^18 samples up a float can't hold a step of
+// 0.01, so adding it to delayInSamples would never get anywhere.
+void PluginProcessor::glideTowardsTarget() noexcept
+{
+    if (float(glideDelay) != delayInSamples) {  // moved by something else
+        glideDelay = delayInSamples;
+    }
+    double distance = double(targetDelay) - glideDelay;
+    glideDelay = std::abs(distance) <= double(glideRate) ? double(targetDelay) : glideDelay + std::copysign(double(glideRate), distance);
+    delayInSamples = float(glideDelay);
+}
+
+// Forgets everything in the delay lines and feedback path.
+void PluginProcessor::clearFeedbackLoop() noexcept
+{
+    auto clear = [] (auto& state) {
+        state.delayLineL.reset();
+        state.delayLineR.reset();
+        state.feedbackL = 0;
+        state.feedbackR = 0;
+        state.feedbackFilter.reset();
+        state.saturator.reset();
+        state.decimator.reset();
+        state.interpolatorL.reset();
+        state.interpolatorR.reset();
+    };
+    clear(floatState);
+    clear(doubleState);
+}
+
+int PluginProcessor::useTimeSlice()
+{
+    for (auto* delayLine : { &floatState.delayLineL, &floatState.delayLineR }) {
+        delayLine->allocateRequestedBuffer();
+    }
+    for (auto* delayLine : { &doubleState.delayLineL, &doubleState.delayLineR }) {
+        delayLine->allocateRequestedBuffer();
     }
-    levelL.updateIfGreater (maxL);
-    levelR.updateIfGreater (maxR);
-    #if JUCE_DEBUG
-    protectYourEars (buffer);
-    #endif
+    loudness.process();
+    diagnostics.drain ([] (const juce::String& line) { juce::Logger::writeToLog (line); });
+    return 20;  // milliseconds until we check again
 }
 
 //==============================================================================
@@ -6,12 +6,24 @@
 #include "Tempo.h"
 #include "DelayLine.h"
 #include "Measurement.h"
+#include "BackgroundThread.h"
+#include "Resampler.h"
+#include "FeedbackFilter.h"
+#include "Saturator.h"
+#include "Kernels.h"
+#include "ProtectYourEars.h"
+#include "DiagnosticLog.h"
+#include "Trace.h"
+#include "ScopeBuffer.h"
+#include "SpectrumAnalyser.h"
+#include "LoudnessMeter.h"
+#include "AssetCache.h"
 
 #if (MSVC)
 #include "ipps.h"
 #endif
 
-class PluginProcessor : public juce::AudioProcessor
+class PluginProcessor : public juce::AudioProcessor, private juce::TimeSliceClient
 {
 public:
     PluginProcessor();
@@ -23,6 +35,8 @@ public:
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -49,12 +63,40 @@ public:
 
     juce::AudioProcessorParameter* getBypassParameter() const override;
     Parameters params;
-    Measurement levelL, levelR;
+    Meters meters;
+    OutputGuard outputGuard;
+    ScopeBuffer scopeBuffer;
+    SpectrumAnalyser spectrum;  // of the feedback, after the filters
+    LoudnessMeter loudness;  // of the output
 private:
-    float feedbackL = 0.0f;
-    float feedbackR = 0.0f;
+    // Everything in the delay loop that holds samples, for one sample type.
+    // prepareToPlay only allocates the delay lines for the precision in use.
+    template <typename SampleType>
+    struct DelayState
+    {
+        BasicDelayLine<SampleType> delayLineL, delayLineR;
+        juce::AudioBuffer<SampleType> wetBuffer;  // wet block copied out of the delay lines
+        BasicFeedbackFilter<SampleType> feedbackFilter;  // low cut and high cut, both channels at once
+        BasicSaturator<SampleType> saturator;  // after the filters, before the delay lines
+        BasicDecimator<SampleType> decimator;
+        BasicInterpolator<SampleType> interpolatorL, interpolatorR;
+        SampleType feedbackL = 0;
+        SampleType feedbackR = 0;
+    };
+
+    template <typename SampleType>
+    void processSamples (juce::AudioBuffer<SampleType>& buffer, DelayState<SampleType>& state) noexcept;
+    int useTimeSlice() override;
+    int decimationForHighCut (float highCut, float sampleRate) const noexcept;
+    void setDecimation (int factor, float sampleRate) noexcept;
+    void glideTowardsTarget() noexcept;
+    void clearFeedbackLoop() noexcept;
+
     float lastLowCut = -1.0f;
     float lastHighCut = -1.0f;
+
+    // delay lines are sized for at least this much at prepareToPlay
+    static constexpr float minAllocatedDelayTime = 500.0f;
     /*
     // For crossfading:
     float delayInSamples = 0.0f;
@@ -72,10 +114,25 @@ private:
     float wait = 0.0f;
     float waitInc = 0.0f;
 
+    // Tempo changes of up to this fraction of the delay glide instead of
+    // ducking, by at most glideRate samples per sample (a 1% pitch bend).
+    static constexpr float maxTempoGlide = 0.05f;
+    static constexpr float glideRate = 0.01f;
+    double glideDelay = 0.0;  // where the glide is, more precisely than delayInSamples
+    bool wasTempoSync = false;
+    int lastDelayNote = -1;
+
+    // For running the delay loop at a lower rate:
+    int decimation = 1;
+    int targetDecimation = 1;
+
     Tempo tempo;
-    DelayLine delayLineL, delayLineR;
+    DelayState<float> floatState;
+    DelayState<double> doubleState;
     // juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> delayLine;
-    juce::dsp::StateVariableTPTFilter<float> lowCutFilter;
-    juce::dsp::StateVariableTPTFilter<float> highCutFilter;
+    juce::SharedResourcePointer<BackgroundThread> backgroundThread;
+    const Kernels* kernels = &Kernels::select();  // picked for this CPU
+    DiagnosticLog diagnostics;  // drained on the background thread
+    juce::SharedResourcePointer<AssetCache> assets;  // decoded in the background for the editor
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
 };
@@ -1,36 +1,96 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+#include <bit>
 
-// Silences the buffer if bad or loud values are detected in the output buffer.
-// Use this during debugging to avoid blowing out your eardrums on headphones.
-inline void protectYourEars(juce::AudioBuffer<float>& buffer)
+// Keeps bad or runaway values away from the host's output, in every build.
+// It doesn't scan the buffer itself: it is handed the peak of the block as
+// float bits (see Kernels::peakBits), which the metering needs anyway, so on
+// normal audio the guard costs one comparison per block.
+//
+// Loud but finite blocks are turned down smoothly, so a hot input with the
+// output gain all the way up keeps playing. Only NaN, infinity or a level no
+// setting can reach silence the block.
+class OutputGuard
 {
-    bool firstWarning = true;
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
-        float* channelData = buffer.getWritePointer(channel);
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
-            float x = channelData[sample];
-            bool silence = false;
-            if (std::isnan(x)) {
-                DBG("!!! WARNING: nan detected in audio buffer, silencing !!!");
-                silence = true;
-            } else if (std::isinf(x)) {
-                DBG("!!! WARNING: inf detected in audio buffer, silencing !!!");
-                silence = true;
-            } else if (x < -2.0f || x > 2.0f) {  // screaming feedback
-                DBG("!!! WARNING: sample out of range, silencing !!!");
-                silence = true;
-            } else if (x < -1.0f || x > 1.0f) {
-                if (firstWarning) {
-                    DBG("!!! WARNING: sample out of range: " << x << " !!!");
-                    firstWarning = false;
-                }
-            }
-            if (silence) {
-                buffer.clear();
-                return;
+public:
+    // a full scale signal with the +12 dB of output gain passes untouched
+    static constexpr float limitLevel = 4.0f;
+
+    // anything above +48 dB is screaming feedback or garbage
+    static constexpr float muteLevel = 256.0f;
+
+    // Turns the block down if its peak is above limitLevel, ramping from
+    // the gain of the previous block. Silences the buffer and returns true
+    // if the peak is above muteLevel, NaN or infinite; the caller should
+    // then clear out its DSP state. The block after a trip fades back in.
+    template <typename SampleType>
+    bool process(juce::AudioBuffer<SampleType>& buffer, uint32_t peakBits) noexcept
+    {
+        if (peakBits > muteLevelBits) {
+            buffer.clear();
+            recovering = true;
+            gain = 1.0f;
+            if (peakBits > infinityBits) {
+                numNaNs.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                numTrips.fetch_add(1, std::memory_order_relaxed);
             }
+            return true;
+        }
+        if (recovering) {
+            buffer.applyGainRamp(0, buffer.getNumSamples(), 0.0f, 1.0f);
+            recovering = false;
         }
+
+        float targetGain = 1.0f;
+        if (peakBits > limitLevelBits) {
+            targetGain = limitLevel / std::bit_cast<float>(peakBits);
+        }
+        // down within a few samples, back up by at most 2 dB a block
+        float newGain = std::min(targetGain, gain * releasePerBlock);
+        if (newGain != 1.0f || gain != 1.0f) {
+            int attack = newGain < gain ? std::min(attackSamples, buffer.getNumSamples()) : buffer.getNumSamples();
+            buffer.applyGainRamp(0, attack, gain, newGain);
+            buffer.applyGain(attack, buffer.getNumSamples() - attack, newGain);
+        }
+        gain = newGain;
+        return false;
+    }
+
+    void reset() noexcept
+    {
+        recovering = false;
+        gain = 1.0f;
+    }
+
+    // what the last block was turned down by, 1 when it wasn't
+    float getGain() const noexcept
+    {
+        return gain;
+    }
+
+    // For reporting off the audio thread: how many blocks were silenced
+    // for being too loud or infinite, and for containing NaNs.
+    int getNumTrips() const noexcept
+    {
+        return numTrips.load(std::memory_order_relaxed);
+    }
+    int getNumNaNs() const noexcept
+    {
+        return numNaNs.load(std::memory_order_relaxed);
     }
-}
+
+private:
+    static constexpr uint32_t limitLevelBits = std::bit_cast<uint32_t>(limitLevel);
+    static constexpr uint32_t muteLevelBits = std::bit_cast<uint32_t>(muteLevel);
+    static constexpr uint32_t infinityBits = 0x7f800000u;
+    static constexpr int attackSamples = 32;
+    static constexpr float releasePerBlock = 1.2589f;  // +2 dB
+
+    bool recovering = false;
+    float gain = 1.0f;
+    std::atomic<int> numTrips = 0;
+    std::atomic<int> numNaNs = 0;
+};
@@ -0,0 +1,185 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+
+#include "Resampler.h"
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace
+{
+    // zeroth order modified Bessel function, for the Kaiser window
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    struct CoefficientTables
+    {
+        CoefficientTables()
+        {
+            design(factor2.data(), 2);
+            design(factor4.data(), 4);
+            design(factor8.data(), 8);
+        }
+
+        // Lowpass with the cutoff at the low rate's Nyquist frequency. The
+        // factor is only chosen when the feedback is band-limited to half of
+        // that, so aliases fold back above the high cut where the loop
+        // filters them out anyway. Kaiser beta 6 gives about 60 dB stopband.
+        static void design(float* coefficients, int factor)
+        {
+            const int numTaps = Resampling::numTaps(factor);
+            const double cutoff = 0.5 / factor;
+            const double centre = 0.5 * (numTaps - 1);
+            const double beta = 6.0;
+
+            double sum = 0.0;
+            for (int i = 0; i < numTaps; ++i) {
+                double t = i - centre;
+                double x = 2.0 * juce::MathConstants<double>::pi * cutoff * t;
+                double sinc = t == 0.0 ? 1.0 : std::sin(x) / x;
+                double r = t / centre;
+                double window = besselI0(beta * std::sqrt(1.0 - r * r)) / besselI0(beta);
+                coefficients[i] = float(sinc * window);
+                sum += sinc * window;
+            }
+            for (int i = 0; i < numTaps; ++i) {
+                coefficients[i] = float(coefficients[i] / sum);  // unity gain at DC
+            }
+        }
+
+        std::array<float, Resampling::numTaps(2)> factor2;
+        std::array<float, Resampling::numTaps(4)> factor4;
+        std::array<float, Resampling::numTaps(8)> factor8;
+    };
+}
+
+const float* Resampling::getCoefficients(int factor) noexcept
+{
+    static const CoefficientTables tables;
+    switch (factor) {
+        case 2: return tables.factor2.data();
+        case 4: return tables.factor4.data();
+        case 8: return tables.factor8.data();
+        default: jassertfalse; return nullptr;
+    }
+}
+
+template <typename SampleType>
+void BasicDecimator<SampleType>::setFactor(int newFactor) noexcept
+{
+    jassert(newFactor == 1 || newFactor == 2 || newFactor == 4 || newFactor == 8);
+    factor = newFactor;
+    numTaps = Resampling::numTaps(factor);
+    coefficients = factor > 1 ? Resampling::getCoefficients(factor) : nullptr;
+    reset();
+}
+
+template <typename SampleType>
+void BasicDecimator<SampleType>::reset() noexcept
+{
+    history.fill(SampleType(0));
+    writeIndex = 0;
+    phase = 0;
+}
+
+template <typename SampleType>
+bool BasicDecimator<SampleType>::process(SampleType input, SampleType& output) noexcept
+{
+    if (factor == 1) {
+        output = input;
+        return true;
+    }
+
+    history[size_t(writeIndex)] = input;
+    history[size_t(writeIndex + numTaps)] = input;
+    writeIndex += 1;
+    if (writeIndex == numTaps) {
+        writeIndex = 0;
+    }
+
+    phase += 1;
+    if (phase < factor) {
+        return false;
+    }
+    phase = 0;
+
+    // history[writeIndex] is now the oldest sample, so this lines up the
+    // oldest input with the last coefficient (they are symmetric anyway)
+    const SampleType* x = history.data() + writeIndex;
+    SampleType sum = 0;
+    for (int i = 0; i < numTaps; ++i) {
+        sum += x[i] * coefficients[i];
+    }
+    output = sum;
+    return true;
+}
+
+template <typename SampleType>
+void BasicInterpolator<SampleType>::setFactor(int newFactor) noexcept
+{
+    jassert(newFactor == 1 || newFactor == 2 || newFactor == 4 || newFactor == 8);
+    factor = newFactor;
+    if (factor > 1) {
+        // phase p uses taps p, p + factor, p + 2 * factor, ... The taps are
+        // stored oldest input first, to match the order of the history.
+        const float* coefficients = Resampling::getCoefficients(factor);
+        for (int p = 0; p < factor; ++p) {
+            for (int k = 0; k < Resampling::tapsPerPhase; ++k) {
+                phases[size_t(p)][size_t(Resampling::tapsPerPhase - 1 - k)] =
+                    SampleType(coefficients[p + k * factor] * float(factor));
+            }
+        }
+    }
+    reset();
+}
+
+template <typename SampleType>
+void BasicInterpolator<SampleType>::reset() noexcept
+{
+    history.fill(SampleType(0));
+    writeIndex = 0;
+    phase = 0;
+}
+
+template <typename SampleType>
+void BasicInterpolator<SampleType>::push(SampleType input) noexcept
+{
+    history[size_t(writeIndex)] = input;
+    history[size_t(writeIndex + Resampling::tapsPerPhase)] = input;
+    writeIndex += 1;
+    if (writeIndex == Resampling::tapsPerPhase) {
+        writeIndex = 0;
+    }
+    phase = 0;
+}
+
+template <typename SampleType>
+SampleType BasicInterpolator<SampleType>::process() noexcept
+{
+    if (factor == 1) {
+        return history[size_t(writeIndex == 0 ? Resampling::tapsPerPhase - 1 : writeIndex - 1)];
+    }
+
+    const SampleType* x = history.data() + writeIndex;
+    const SampleType* h = phases[size_t(phase)].data();
+    SampleType sum = 0;
+    for (int i = 0; i < Resampling::tapsPerPhase; ++i) {
+        sum += x[i] * h[i];
+    }
+    if (phase < factor - 1) {
+        phase += 1;
+    }
+    return sum;
+}
+
+template class BasicDecimator<float>;
+template class BasicDecimator<double>;
+template class BasicInterpolator<float>;
+template class BasicInterpolator<double>;
@@ -0,0 +1,80 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <array>
+
+// Polyphase FIR decimator and interpolator used to run the delay and
+// feedback loop at a fraction of the host sample rate. Both use the same
+// Kaiser-windowed sinc lowpass at half the low sample rate, 8 taps per phase.
+// Both are templated on the sample type for the float and double paths; the
+// coefficients are the same float tables either way.
+namespace Resampling
+{
+    constexpr int maxFactor = 8;
+    constexpr int tapsPerPhase = 8;
+    constexpr int maxTaps = maxFactor * tapsPerPhase;
+
+    // the lowpass for a factor of 2, 4 or 8, with numTaps(factor) taps
+    const float* getCoefficients(int factor) noexcept;
+
+    constexpr int numTaps(int factor) noexcept
+    {
+        return factor * tapsPerPhase;
+    }
+
+    // latency of going down and back up again, in host samples
+    constexpr int getLatency(int factor) noexcept
+    {
+        return factor > 1 ? numTaps(factor) - 1 : 0;
+    }
+}
+
+template <typename SampleType>
+class BasicDecimator
+{
+public:
+    void setFactor(int newFactor) noexcept;
+    void reset() noexcept;
+
+    // Takes one sample at the host rate. Every factor-th call a new sample
+    // at the low rate is put into output and the function returns true.
+    bool process(SampleType input, SampleType& output) noexcept;
+
+private:
+    const float* coefficients = nullptr;
+    int factor = 1;
+    int numTaps = 1;
+    int writeIndex = 0;
+    int phase = 0;
+
+    // every input is stored twice, so the newest numTaps are always contiguous
+    std::array<SampleType, 2 * Resampling::maxTaps> history {};
+};
+
+template <typename SampleType>
+class BasicInterpolator
+{
+public:
+    void setFactor(int newFactor) noexcept;
+    void reset() noexcept;
+
+    // Adds the next sample at the low rate. Call this every factor-th sample,
+    // before process().
+    void push(SampleType input) noexcept;
+
+    // Returns the next output sample at the host rate.
+    SampleType process() noexcept;
+
+private:
+    int factor = 1;
+    int writeIndex = 0;
+    int phase = 0;
+
+    // the lowpass split into its phases, scaled by the factor
+    std::array<std::array<SampleType, Resampling::tapsPerPhase>, Resampling::maxFactor> phases {};
+    std::array<SampleType, 2 * Resampling::tapsPerPhase> history {};
+};
+
+using Decimator = BasicDecimator<float>;
+using Interpolator = BasicInterpolator<float>;
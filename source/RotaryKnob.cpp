@@ -7,7 +7,7 @@
 
 RotaryKnob::RotaryKnob(const juce::String& text, juce::AudioProcessorValueTreeState& apvts,
     const juce::ParameterID& parameterID, bool drawFromMiddle)
-    : attachment(apvts, parameterID.getParamID(), slider)
+    : attachment(*apvts.getParameter(parameterID.getParamID()), slider)
 {
     slider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
     slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, 16);
@@ -18,6 +18,7 @@ RotaryKnob::RotaryKnob(const juce::String& text, juce::AudioProcessorValueTreeSt
     label.setJustificationType(juce::Justification::horizontallyCentred);
     label.setBorderSize(juce::BorderSize<int>{ 0, 0, 2, 0 });
     label.attachToComponent(&slider, false);
+    label.getProperties().set("staticText", true);  // laid out once, see drawLabel
     addAndMakeVisible(label);
 
     float pi = juce::MathConstants<float>::pi;
@@ -4,6 +4,7 @@
 #pragma once
 // #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "ParameterAttachments.h"
 
 class RotaryKnob  : public juce::Component
 {
@@ -16,7 +17,7 @@ public:
 
     juce::Slider slider;
     juce::Label label;
-    juce::AudioProcessorValueTreeState::SliderAttachment attachment;
+    PolledSliderAttachment attachment;  // the editor calls update() every frame
 
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RotaryKnob)
@@ -0,0 +1,158 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+// Sample formats the delay history can be stored in. Each format converts
+// single samples for the per-sample delay loop, and whole blocks with loops
+// that are branch-free so the compiler can vectorise them.
+
+// plain 32-bit float, lossless
+struct Float32Storage
+{
+    using Type = float;
+
+    static Type encode(float x) noexcept { return x; }
+    static float decode(Type x) noexcept { return x; }
+
+    static void encode(const float* source, Type* destination, int numSamples) noexcept
+    {
+        std::copy(source, source + numSamples, destination);
+    }
+    static void decode(const Type* source, float* destination, int numSamples) noexcept
+    {
+        std::copy(source, source + numSamples, destination);
+    }
+};
+
+// 64-bit double, for the double precision path. Always lossless, whatever
+// format the float path uses.
+struct Float64Storage
+{
+    using Type = double;
+
+    static Type encode(double x) noexcept { return x; }
+    static double decode(Type x) noexcept { return x; }
+
+    static void encode(const double* source, Type* destination, int numSamples) noexcept
+    {
+        std::copy(source, source + numSamples, destination);
+    }
+    static void decode(const Type* source, double* destination, int numSamples) noexcept
+    {
+        std::copy(source, source + numSamples, destination);
+    }
+};
+
+// 16-bit fixed point. Anything beyond +/- maxLevel (+6 dB) is clipped,
+// which only happens with runaway feedback.
+struct Int16Storage
+{
+    using Type = int16_t;
+    static constexpr float maxLevel = 2.0f;
+
+    static Type encode(float x) noexcept
+    {
+        // written so that a NaN ends up clipped rather than undefined
+        float scaled = std::min(32767.0f, std::max(-32767.0f, x * (32767.0f / maxLevel)));
+        return Type(scaled + (scaled < 0.0f ? -0.5f : 0.5f));  // round to nearest
+    }
+    static float decode(Type x) noexcept
+    {
+        return float(x) * (maxLevel / 32767.0f);
+    }
+
+    static void encode(const float* source, Type* destination, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i) {
+            destination[i] = encode(source[i]);
+        }
+    }
+    static void decode(const Type* source, float* destination, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i) {
+            destination[i] = decode(source[i]);
+        }
+    }
+};
+
+// The top half of a 32-bit float: same range, 8 bits of mantissa.
+struct BFloat16Storage
+{
+    using Type = uint16_t;
+
+    static Type encode(float x) noexcept
+    {
+        uint32_t bits = std::bit_cast<uint32_t>(x);
+        bits += 0x7fffu + ((bits >> 16) & 1u);  // round to nearest even
+        return Type(bits >> 16);
+    }
+    static float decode(Type x) noexcept
+    {
+        return std::bit_cast<float>(uint32_t(x) << 16);
+    }
+
+    static void encode(const float* source, Type* destination, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i) {
+            destination[i] = encode(source[i]);
+        }
+    }
+    static void decode(const Type* source, float* destination, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i) {
+            destination[i] = decode(source[i]);
+        }
+    }
+};
+
+// IEEE half precision: 10 bits of mantissa, largest value 65504.
+// Converted in software so it doesn't depend on F16C or ARM fp16 support.
+struct Float16Storage
+{
+    using Type = uint16_t;
+
+    static Type encode(float x) noexcept
+    {
+        uint32_t bits = std::bit_cast<uint32_t>(x);
+        uint32_t sign = (bits >> 16) & 0x8000u;
+        uint32_t magnitude = bits & 0x7fffffffu;
+
+        // rebias the exponent from 127 to 15, round the mantissa to 10 bits
+        uint32_t normal = (magnitude - 0x38000000u + 0x0fffu + ((magnitude >> 13) & 1u)) >> 13;
+        // below 2^-14 the half is subnormal, in steps of 2^-24
+        float small = std::min(6.1035156e-5f, std::bit_cast<float>(magnitude));  // 2^-14
+        uint32_t subnormal = uint32_t(small * 16777216.0f + 0.5f);
+
+        uint32_t half = magnitude < 0x38800000u ? subnormal : normal;
+        half = magnitude >= 0x47800000u ? 0x7c00u : half;  // too large or not a number
+        return Type(sign | half);
+    }
+    static float decode(Type x) noexcept
+    {
+        uint32_t sign = uint32_t(x & 0x8000u) << 16;
+        uint32_t magnitude = x & 0x7fffu;
+
+        uint32_t normal = (magnitude << 13) + 0x38000000u;
+        uint32_t subnormal = std::bit_cast<uint32_t>(float(magnitude) * 5.9604645e-8f);  // 2^-24
+        uint32_t bits = magnitude < 0x0400u ? subnormal : normal;
+        bits = magnitude >= 0x7c00u ? 0x7f800000u : bits;
+        return std::bit_cast<float>(sign | bits);
+    }
+
+    static void encode(const float* source, Type* destination, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i) {
+            destination[i] = encode(source[i]);
+        }
+    }
+    static void decode(const Type* source, float* destination, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i) {
+            destination[i] = decode(source[i]);
+        }
+    }
+};
@@ -0,0 +1,13 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#include "Saturator.h"
+
+template <typename SampleType>
+void BasicSaturator<SampleType>::reset() noexcept
+{
+    previous = Vec::expand(0);
+}
+
+template class BasicSaturator<float>;
+template class BasicSaturator<double>;
@@ -0,0 +1,94 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+
+// Tape style saturation for the feedback path. The curve is the cubic soft
+// clipper f(x) = x - 4x^3/27, which is linear for small signals and bends
+// smoothly over to a ceiling of 1 at an input of 1.5, flat beyond that.
+//
+// Waveshaping inside the loop would alias, and every pass through the loop
+// would fold more back. Instead of oversampling, this uses first-order
+// antiderivative anti-aliasing (ADAA): the output is the mean of f between
+// the previous input and this one,
+//     y[n] = (F(x[n]) - F(x[n-1])) / (x[n] - x[n-1]),   F' = f.
+// That mean costs half a sample of delay and a gentle high cut on each pass,
+// which is why the processor only runs it while there is some drive, and
+// mixes it in with the drive: at 0 the loop stays exactly linear. Both
+// channels share the lanes of a SIMD register, like BasicFeedbackFilter;
+// only the division is done lane by lane.
+template <typename SampleType>
+class BasicSaturator
+{
+    public:
+        void reset() noexcept;
+
+        // Drive from 0 to 1 raises the level into the curve by up to 24 dB,
+        // brings it back down after, and crossfades from the dry signal.
+        void process(SampleType& left, SampleType& right, SampleType drive) noexcept
+        {
+            alignas(Vec::SIMDRegisterSize) SampleType lanes[Vec::size()] = { left, right };
+            Vec dry = Vec::fromRawArray(lanes);
+            SampleType inputGain = SampleType(1) + SampleType(15) * drive;
+
+            Vec wet = shape(dry * Vec::expand(inputGain));
+            Vec y = wet * Vec::expand(drive / inputGain) + dry * Vec::expand(SampleType(1) - drive);
+
+            y.copyToRawArray(lanes);
+            left = lanes[0];
+            right = lanes[1];
+        }
+
+        // the curve on its own, without drive or makeup
+        void process(SampleType& left, SampleType& right) noexcept
+        {
+            alignas(Vec::SIMDRegisterSize) SampleType lanes[Vec::size()] = { left, right };
+            shape(Vec::fromRawArray(lanes)).copyToRawArray(lanes);
+            left = lanes[0];
+            right = lanes[1];
+        }
+
+    private:
+        using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+        Vec shape(Vec x) noexcept
+        {
+            alignas(Vec::SIMDRegisterSize) SampleType lanes[Vec::size()];
+            alignas(Vec::SIMDRegisterSize) SampleType steps[Vec::size()];
+            alignas(Vec::SIMDRegisterSize) SampleType shaped[Vec::size()];
+
+            // F is the cubic part of the clipped input, plus the linear tail
+            // for however far the input sticks out past the clip point.
+            Vec ceiling = Vec::expand(clipPoint);
+            Vec clipped = Vec::min(Vec::max(x, Vec::expand(0) - ceiling), ceiling);
+            Vec clippedPrevious = Vec::min(Vec::max(previous, Vec::expand(0) - ceiling), ceiling);
+            Vec excess = Vec::abs(x) - Vec::abs(clipped);
+            Vec excessPrevious = Vec::abs(previous) - Vec::abs(clippedPrevious);
+
+            // (P(a) - P(b)) / (a - b) for the cubic part P(x) = x^2/2 - x^4/27,
+            // worked out so it needs no division and doesn't cancel
+            Vec sum = clipped + clippedPrevious;
+            Vec cubicMean = sum * Vec::expand(SampleType(0.5))
+                - sum * (clipped * clipped + clippedPrevious * clippedPrevious) * Vec::expand(SampleType(1.0 / 27.0));
+            Vec difference = cubicMean * (clipped - clippedPrevious) + excess - excessPrevious;
+            Vec step = x - previous;
+            Vec curve = clipped - clipped * clipped * clipped * Vec::expand(SampleType(4.0 / 27.0));
+
+            difference.copyToRawArray(lanes);
+            step.copyToRawArray(steps);
+            curve.copyToRawArray(shaped);
+            previous = x;
+
+            // where the input stood still, the mean is f itself
+            for (size_t i = 0; i < 2; ++i) {
+                lanes[i] = steps[i] != SampleType(0) ? lanes[i] / steps[i] : shaped[i];
+            }
+            return Vec::fromRawArray(lanes);
+        }
+
+        static constexpr SampleType clipPoint = SampleType(1.5);
+        Vec previous = Vec::expand(0);
+};
+
+using Saturator = BasicSaturator<float>;
@@ -0,0 +1,90 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+#include <limits>
+
+// The smallest and largest dry and wet sample over a short stretch of audio.
+struct ScopePoint
+{
+    float dryMin, dryMax;
+    float wetMin, wetMax;
+};
+
+// Hands a decimated min/max history of the dry and wet signals from the
+// audio thread to the editor's scope. A lock-free single producer, single
+// consumer ring; nothing allocates after construction. If the editor isn't
+// reading, new points are dropped.
+class ScopeBuffer
+{
+public:
+    static constexpr int capacity = 1024;
+    static constexpr double pointsPerSecond = 200.0;
+
+    // Not while the audio thread is pushing, but the editor may be reading.
+    // Only the reader may move the read position, so rather than resetting
+    // the fifo this starts a new generation of points, and the reader skips
+    // any left over from the one before.
+    void prepare(double sampleRate) noexcept
+    {
+        samplesPerPoint = std::max(1, int(sampleRate / pointsPerSecond));
+        writeGeneration = generation.fetch_add(1, std::memory_order_relaxed) + 1;
+        startPoint();
+    }
+
+    // Audio thread, once per sample.
+    void push(float dry, float wet) noexcept
+    {
+        current.dryMin = std::min(current.dryMin, dry);
+        current.dryMax = std::max(current.dryMax, dry);
+        current.wetMin = std::min(current.wetMin, wet);
+        current.wetMax = std::max(current.wetMax, wet);
+        if (++count == samplesPerPoint) {
+            auto scope = fifo.write(1);
+            if (scope.blockSize1 > 0) {
+                points[size_t(scope.startIndex1)] = current;
+                pointGenerations[size_t(scope.startIndex1)] = writeGeneration;
+            }
+            startPoint();
+        }
+    }
+
+    // Message thread. Copies out up to maxPoints of the oldest points and
+    // returns how many there were.
+    int read(ScopePoint* destination, int maxPoints) noexcept
+    {
+        // points from before the last prepare are at the old rate
+        uint32_t latest = generation.load(std::memory_order_relaxed);
+        auto scope = fifo.read(std::min(maxPoints, fifo.getNumReady()));
+        int numRead = 0;
+        scope.forEach([&](int index) {
+            if (pointGenerations[size_t(index)] == latest) {
+                destination[numRead++] = points[size_t(index)];
+            }
+        });
+        return numRead;
+    }
+
+private:
+    // seeded so the first sample of the stretch sets both extremes
+    void startPoint() noexcept
+    {
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        current = { inf, -inf, inf, -inf };
+        count = 0;
+    }
+
+    juce::AbstractFifo fifo { capacity };
+    std::array<ScopePoint, capacity> points {};
+    std::array<uint32_t, capacity> pointGenerations {};
+    std::atomic<uint32_t> generation = 0;
+
+    // audio thread only
+    ScopePoint current {};
+    int count = 0;
+    int samplesPerPoint = 1;
+    uint32_t writeGeneration = 0;
+};
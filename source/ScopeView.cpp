@@ -0,0 +1,57 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#include "ScopeView.h"
+#include "LookAndFeel.h"
+
+ScopeView::ScopeView(ScopeBuffer& scopeBuffer_) : scopeBuffer(scopeBuffer_)
+{
+    setOpaque(true);
+}
+
+void ScopeView::paint(juce::Graphics& g)
+{
+    g.fillAll(Colors::Scope::background);
+
+    g.setColour(Colors::Scope::centerLine);
+    g.fillRect(0, getHeight() / 2, getWidth(), 1);
+
+    g.setColour(Colors::Scope::dry);
+    drawPoints(g, false);
+    g.setColour(Colors::Scope::wet);
+    drawPoints(g, true);
+}
+
+void ScopeView::resized()
+{
+    history.assign(size_t(std::max(1, getWidth())), ScopePoint {});
+    writeIndex = 0;
+}
+
+void ScopeView::update()
+{
+    int numPoints = scopeBuffer.read(incoming.data(), int(incoming.size()));
+    if (numPoints == 0 || history.empty()) {
+        return;
+    }
+    for (int i = 0; i < numPoints; ++i) {
+        history[writeIndex] = incoming[size_t(i)];
+        writeIndex = (writeIndex + 1) % history.size();
+    }
+    repaint();
+}
+
+void ScopeView::drawPoints(juce::Graphics& g, bool wet) const
+{
+    float centre = float(getHeight()) * 0.5f;
+    float scale = centre - 1.0f;  // full scale touches the edges
+
+    for (size_t x = 0; x < history.size(); ++x) {
+        const ScopePoint& point = history[(writeIndex + x) % history.size()];
+        float low = wet ? point.wetMin : point.dryMin;
+        float high = wet ? point.wetMax : point.dryMax;
+        float top = centre - std::clamp(high, -1.0f, 1.0f) * scale;
+        float bottom = centre - std::clamp(low, -1.0f, 1.0f) * scale;
+        g.drawVerticalLine(int(x), top, std::max(bottom, top + 1.0f));
+    }
+}
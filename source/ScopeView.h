@@ -0,0 +1,33 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <vector>
+#include "ScopeBuffer.h"
+
+// Draws the dry and wet signals as a waveform scrolling from right to left,
+// one pixel per ScopePoint, so the echoes and any feedback build-up can be
+// seen at a glance.
+class ScopeView : public juce::Component
+{
+public:
+    explicit ScopeView(ScopeBuffer& scopeBuffer);
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+    // Called by the editor once per display frame.
+    void update();
+
+private:
+    void drawPoints(juce::Graphics& g, bool wet) const;
+
+    ScopeBuffer& scopeBuffer;
+
+    // the last getWidth() points, oldest at writeIndex
+    std::vector<ScopePoint> history;
+    size_t writeIndex = 0;
+    std::array<ScopePoint, ScopeBuffer::capacity> incoming;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeView)
+};
@@ -0,0 +1,88 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#include "SpectrumAnalyser.h"
+
+SpectrumAnalyser::SpectrumAnalyser()
+{
+    smoothed.fill(mindB);
+    result.fill(mindB);
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    stop();
+}
+
+void SpectrumAnalyser::start()
+{
+    active.store(true, std::memory_order_relaxed);
+    backgroundThread->addTimeSliceClient(this);
+}
+
+void SpectrumAnalyser::stop()
+{
+    // waits if the thread is in the middle of analysing
+    backgroundThread->removeTimeSliceClient(this);
+    active.store(false, std::memory_order_relaxed);
+}
+
+void SpectrumAnalyser::flush() noexcept
+{
+    // if the background thread falls behind, the newest samples are lost
+    auto scope = fifo.write(std::min(numStaged, fifo.getFreeSpace()));
+    int index = 0;
+    scope.forEach([&](int destination) {
+        fifoData[size_t(destination)] = staging[size_t(index++)];
+    });
+    numStaged = 0;
+}
+
+void SpectrumAnalyser::analyse()
+{
+    int numReady = fifo.getNumReady();
+    if (numReady == 0) {
+        return;
+    }
+
+    // slide the history along and append the new samples
+    int numNew = std::min(numReady, fftSize);
+    fifo.finishedRead(numReady - numNew);  // more than fits, skip the oldest
+    std::copy(history.begin() + numNew, history.end(), history.begin());
+    auto scope = fifo.read(numNew);
+    int index = fftSize - numNew;
+    scope.forEach([&](int source) {
+        history[size_t(index++)] = fifoData[size_t(source)];
+    });
+
+    std::copy(history.begin(), history.end(), fftData.begin());
+    window.multiplyWithWindowingTable(fftData.data(), size_t(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // a full scale sine reads 0 dB, the hann window halves its amplitude
+    const float scale = 4.0f / float(fftSize);
+    const float decay = 0.2f;
+    for (size_t bin = 0; bin < size_t(numBins); ++bin) {
+        float dB = juce::Decibels::gainToDecibels(fftData[bin] * scale, mindB);
+        if (dB > smoothed[bin]) {
+            smoothed[bin] = dB;  // instantaneous attack
+        } else {
+            smoothed[bin] += (dB - smoothed[bin]) * decay;
+        }
+    }
+
+    const juce::ScopedLock lock(resultLock);
+    result = smoothed;
+}
+
+void SpectrumAnalyser::getMagnitudes(std::array<float, numBins>& destination) const
+{
+    const juce::ScopedLock lock(resultLock);
+    destination = result;
+}
+
+int SpectrumAnalyser::useTimeSlice()
+{
+    analyse();
+    return 33;  // about 30 frames per second
+}
@@ -0,0 +1,86 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include "BackgroundThread.h"
+
+// Spectrum of the feedback signal for the editor. The audio thread only
+// copies samples into a lock-free FIFO, and only while an editor is showing
+// the spectrum. The windowing, FFT and smoothing run on the shared
+// background thread at display rate.
+class SpectrumAnalyser : private juce::TimeSliceClient
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = fftSize / 2;
+    static constexpr float mindB = -100.0f;
+
+    SpectrumAnalyser();
+    ~SpectrumAnalyser() override;
+
+    // Message thread, from the editor: analysis only runs in between.
+    void start();
+    void stop();
+
+    bool isActive() const noexcept
+    {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    // The rate of the samples that are pushed, which follows the decimation.
+    void setSampleRate(double sampleRate) noexcept
+    {
+        currentSampleRate.store(sampleRate, std::memory_order_relaxed);
+    }
+    double getSampleRate() const noexcept
+    {
+        return currentSampleRate.load(std::memory_order_relaxed);
+    }
+
+    // Audio thread. Samples are staged and handed over a block at a time.
+    void push(float sample) noexcept
+    {
+        staging[size_t(numStaged++)] = sample;
+        if (numStaged == int(staging.size())) {
+            flush();
+        }
+    }
+    void flush() noexcept;
+
+    // Takes the waiting samples and updates the spectrum. Normally called
+    // on the background thread.
+    void analyse();
+
+    // Copies out the smoothed spectrum in dB, bin k at k * sampleRate / fftSize.
+    void getMagnitudes(std::array<float, numBins>& destination) const;
+
+private:
+    int useTimeSlice() override;
+
+    std::atomic<bool> active = false;
+    std::atomic<double> currentSampleRate = 44100.0;
+
+    // audio thread
+    std::array<float, 512> staging {};
+    int numStaged = 0;
+
+    juce::AbstractFifo fifo { 16384 };
+    std::vector<float> fifoData = std::vector<float>(16384);
+
+    // background thread
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { size_t(fftSize), juce::dsp::WindowingFunction<float>::hann };
+    std::vector<float> history = std::vector<float>(fftSize);  // the last fftSize samples, oldest first
+    std::vector<float> fftData = std::vector<float>(2 * fftSize);
+    std::array<float, numBins> smoothed {};
+
+    juce::CriticalSection resultLock;
+    std::array<float, numBins> result {};
+
+    juce::SharedResourcePointer<BackgroundThread> backgroundThread;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyser)
+};
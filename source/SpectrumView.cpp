@@ -0,0 +1,69 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#include "SpectrumView.h"
+#include "LookAndFeel.h"
+
+SpectrumView::SpectrumView(SpectrumAnalyser& analyser_) : analyser(analyser_)
+{
+    setOpaque(true);
+    magnitudes.fill(SpectrumAnalyser::mindB);
+    analyser.start();
+}
+
+SpectrumView::~SpectrumView()
+{
+    analyser.stop();
+}
+
+void SpectrumView::paint(juce::Graphics& g)
+{
+    g.fillAll(Colors::Scope::background);
+
+    const float width = float(getWidth());
+    const float height = float(getHeight());
+    auto xForFrequency = [&](float frequency) {
+        return width * std::log(frequency / minFrequency) / std::log(maxFrequency / minFrequency);
+    };
+    auto yForLevel = [&](float dB) {
+        return juce::jmap(juce::jlimit(mindB, maxdB, dB), maxdB, mindB, 0.0f, height);
+    };
+
+    g.setColour(Colors::Scope::centerLine);
+    for (float frequency : { 100.0f, 1000.0f, 10000.0f }) {
+        g.fillRect(xForFrequency(frequency), 0.0f, 1.0f, height);
+    }
+
+    double binWidth = analyser.getSampleRate() / SpectrumAnalyser::fftSize;
+    juce::Path path;
+    path.startNewSubPath(0.0f, height);
+    for (int bin = 1; bin < SpectrumAnalyser::numBins; ++bin) {
+        float frequency = float(bin * binWidth);
+        if (frequency < minFrequency) {
+            continue;
+        }
+        if (frequency > maxFrequency) {
+            break;
+        }
+        path.lineTo(xForFrequency(frequency), yForLevel(magnitudes[size_t(bin)]));
+    }
+    path.lineTo(path.getCurrentPosition().x, height);
+    path.closeSubPath();
+
+    g.setColour(Colors::Scope::wet.withAlpha(0.5f));
+    g.fillPath(path);
+    g.setColour(Colors::Scope::wet);
+    g.strokePath(path, juce::PathStrokeType(1.0f));
+}
+
+void SpectrumView::update()
+{
+    double now = juce::Time::getMillisecondCounterHiRes();
+    if (now - lastUpdateTime < 1000.0 / refreshRate) {
+        return;
+    }
+    lastUpdateTime = now;
+
+    analyser.getMagnitudes(magnitudes);
+    repaint();
+}
@@ -0,0 +1,33 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "SpectrumAnalyser.h"
+
+// Draws the analyser's spectrum on a log frequency axis from 20 Hz to 20 kHz.
+// Starts the analyser when it's created and stops it again when it goes away.
+class SpectrumView : public juce::Component
+{
+public:
+    explicit SpectrumView(SpectrumAnalyser& analyser);
+    ~SpectrumView() override;
+
+    void paint(juce::Graphics&) override;
+
+    // Called by the editor once per display frame, redraws at refreshRate.
+    void update();
+
+private:
+
+    static constexpr int refreshRate = 30;
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float mindB = -90.0f;
+    static constexpr float maxdB = 0.0f;
+
+    SpectrumAnalyser& analyser;
+    double lastUpdateTime = 0.0;
+    std::array<float, SpectrumAnalyser::numBins> magnitudes {};
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumView)
+};
@@ -24,23 +24,75 @@ static std::array<double, 16> noteLengthMultipliers =
     4.0,          // 15 = 1/1
 };
 
+// Hosts report the tempo with some jitter, and the PPQ measurement has
+// rounding in it, so only a relative change larger than this is a change.
+static constexpr double tempoTolerance = 1e-4;
+
+void Tempo::prepare(double newSampleRate) noexcept
+{
+    sampleRate = newSampleRate;
+    reset();
+}
+
 void Tempo::reset() noexcept
 {
-    bpm = 120.0;
+    lastTimeInSamples = -1;
+    lastNumSamples = 0;
+    bpm = 0.0;
+    setTempo(120.0);
 }
-void Tempo::update(const juce::AudioPlayHead* playhead) noexcept
+
+void Tempo::update(const juce::AudioPlayHead* playhead, int numSamples) noexcept
 {
-    reset();
-    if (playhead == nullptr) {return;}
-    const auto opt = playhead->getPosition();
-    if(!opt.hasValue()) {return;}
-    const auto& pos = *opt;
-    if (pos.getBpm().hasValue()) {
-        bpm = *pos.getBpm();
+    // without a host tempo, the last one we had stays
+    double newBpm = bpm;
+    juce::int64 timeInSamples = -1;
+    double ppqPosition = 0.0;
+
+    if (playhead != nullptr) {
+        if (const auto position = playhead->getPosition(); position.hasValue()) {
+            if (position->getBpm().hasValue()) {
+                newBpm = *position->getBpm();
+            }
+            if (position->getPpqPosition().hasValue() && position->getTimeInSamples().hasValue()) {
+                ppqPosition = *position->getPpqPosition();
+                timeInSamples = *position->getTimeInSamples();
+            }
+
+            // Playing on from where the last block ended: the tempo that
+            // really applied is the number of quarter notes it covered.
+            bool continuous = position->getIsPlaying() && lastTimeInSamples >= 0 && lastNumSamples > 0
+                && timeInSamples == lastTimeInSamples + lastNumSamples;
+            double quarterNotes = ppqPosition - lastPpqPosition;
+            if (continuous && quarterNotes > 0.0) {
+                newBpm = quarterNotes * 60.0 * sampleRate / double(lastNumSamples);
+            }
+        }
+    }
+
+    lastPpqPosition = ppqPosition;
+    lastTimeInSamples = timeInSamples;
+    lastNumSamples = numSamples;
+    setTempo(newBpm);
+}
+
+void Tempo::setTempo(double newBpm) noexcept
+{
+    newBpm = std::clamp(newBpm, 10.0, 999.0);
+    if (std::abs(newBpm - bpm) <= tempoTolerance * bpm) {
+        return;
+    }
+    bpm = newBpm;
+
+    // Note lengths are counted in quarter notes, the unit of both the tempo
+    // and the PPQ position, so the time signature doesn't come into it.
+    double samplesPerQuarterNote = 60.0 * sampleRate / bpm;
+    for (size_t i = 0; i < samplesForNote.size(); ++i) {
+        samplesForNote[i] = noteLengthMultipliers[i] * samplesPerQuarterNote;
     }
 }
 
 double Tempo::getMillisecondsForNoteLength(int index) const noexcept
 {
     return 60000.0 * noteLengthMultipliers[size_t(index)] / bpm;
-}
\ No newline at end of file
+}
@@ -7,13 +7,35 @@
 class Tempo
 {
     public:
+        void prepare(double newSampleRate) noexcept;
         void reset() noexcept;
-        void update(const juce::AudioPlayHead* playhead) noexcept;
+
+        // Reads the tempo for the block that is about to be processed. While
+        // the host is playing it is measured from how far the PPQ position
+        // moved over the previous block, so it is locked to the sample
+        // position, and jitter below a small tolerance is ignored.
+        void update(const juce::AudioPlayHead* playhead, int numSamples) noexcept;
+
         double getMillisecondsForNoteLength(int index) const noexcept;
+
+        // The same length in samples, only recomputed when the tempo changes.
+        double getSamplesForNoteLength(int index) const noexcept
+        {
+            return samplesForNote[size_t(index)];
+        }
         double getTempo() const noexcept
         {
             return bpm;
         }
     private:
+        void setTempo(double newBpm) noexcept;
+
         double bpm = 120.0;
-};
\ No newline at end of file
+        double sampleRate = 44100.0;
+        std::array<double, 16> samplesForNote {};
+
+        // where the previous block started, -1 if unknown
+        double lastPpqPosition = 0.0;
+        juce::int64 lastTimeInSamples = -1;
+        int lastNumSamples = 0;
+};
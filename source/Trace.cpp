@@ -0,0 +1,125 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#include "Trace.h"
+
+#if DELAY_TRACING
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace
+{
+    namespace
+    {
+        struct Zone
+        {
+            const char* name;
+            juce::int64 start, end;
+        };
+
+        // One per thread, written only by its thread. numZones is published
+        // after the zone is filled in, so the exporter can read up to it.
+        struct ThreadBuffer
+        {
+            static constexpr int capacity = 1 << 16;
+
+            int threadIndex = 0;
+            std::atomic<int> numZones = 0;
+            std::array<Zone, capacity> zones;
+        };
+
+        // Buffers live until the process ends, so a thread that exits
+        // doesn't take its zones with it.
+        std::mutex registryLock;
+        std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+        // made by registerThread() for the next thread to come along
+        std::atomic<ThreadBuffer*> spare = nullptr;
+
+        // registryLock must be held
+        ThreadBuffer* addThreadBuffer()
+        {
+            registry.push_back(std::make_unique<ThreadBuffer>());
+            registry.back()->threadIndex = int(registry.size());
+            return registry.back().get();
+        }
+
+        ThreadBuffer& getThreadBuffer()
+        {
+            thread_local ThreadBuffer* buffer = [] {
+                if (ThreadBuffer* ready = spare.exchange(nullptr)) {
+                    return ready;
+                }
+                std::lock_guard<std::mutex> lock(registryLock);
+                return addThreadBuffer();
+            }();
+            return *buffer;
+        }
+    }
+
+    void registerThread()
+    {
+        getThreadBuffer();
+        std::lock_guard<std::mutex> lock(registryLock);
+        if (spare.load() == nullptr) {
+            spare.store(addThreadBuffer());
+        }
+    }
+
+    Scope::Scope(const char* zoneName) noexcept : name(zoneName), start(juce::Time::getHighResolutionTicks())
+    {
+    }
+
+    Scope::~Scope() noexcept
+    {
+        juce::int64 end = juce::Time::getHighResolutionTicks();
+        ThreadBuffer& buffer = getThreadBuffer();
+        int index = buffer.numZones.load(std::memory_order_relaxed);
+        if (index < ThreadBuffer::capacity) {  // when full, stop recording
+            buffer.zones[size_t(index)] = { name, start, end };
+            buffer.numZones.store(index + 1, std::memory_order_release);
+        }
+    }
+
+    bool writeChromeTrace(const juce::File& file)
+    {
+        double microsecondsPerTick = 1.0e6 / double(juce::Time::getHighResolutionTicksPerSecond());
+
+        juce::String json;
+        json << "{\"traceEvents\":[\n";
+        bool first = true;
+
+        std::lock_guard<std::mutex> lock(registryLock);
+        for (auto& buffer : registry) {
+            int numZones = buffer->numZones.load(std::memory_order_acquire);
+            for (int i = 0; i < numZones; ++i) {
+                const Zone& zone = buffer->zones[size_t(i)];
+                if (!first) {
+                    json << ",\n";
+                }
+                first = false;
+                json << "{\"name\":\"" << zone.name << "\",\"ph\":\"X\",\"pid\":1"
+                     << ",\"tid\":" << buffer->threadIndex
+                     << ",\"ts\":" << juce::String(double(zone.start) * microsecondsPerTick, 3)
+                     << ",\"dur\":" << juce::String(double(zone.end - zone.start) * microsecondsPerTick, 3)
+                     << "}";
+            }
+        }
+        json << "\n]}\n";
+        return file.replaceWithText(json);
+    }
+
+    void clear() noexcept
+    {
+        std::lock_guard<std::mutex> lock(registryLock);
+        for (auto& buffer : registry) {
+            buffer->numZones.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,64 @@
+//
+// Created by Myra Norton on 10/19/26.
+//
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// Scoped trace zones for seeing where the time goes inside the callbacks.
+// Only built when the DELAY_TRACING CMake option is on; otherwise
+// TRACE_SCOPE compiles to nothing.
+//
+//     TRACE_SCOPE("delay loop");
+//     TRACE_REGISTER_THREAD();  // in prepareToPlay
+//
+// The name must be a string literal. Every thread records into its own
+// fixed-size buffer without locking; writeChromeTrace() saves everything
+// recorded so far as a Chrome trace, which Perfetto and chrome://tracing
+// can open.
+
+#ifndef DELAY_TRACING
+    #define DELAY_TRACING 0
+#endif
+
+#if DELAY_TRACING
+
+namespace Trace
+{
+    // Recording a zone. The first zone on a thread that wasn't registered
+    // takes the buffer registerThread() kept ready, or else allocates one
+    // under a lock.
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name) noexcept;
+        ~Scope() noexcept;
+
+    private:
+        const char* name;
+        juce::int64 start;
+    };
+
+    // Gives the calling thread its buffer, and keeps one ready for the next
+    // thread that records a zone, which can then take it without locking or
+    // allocating. Call it from prepareToPlay, so the audio thread's first
+    // zone is realtime safe whichever thread the host prepares on.
+    void registerThread();
+
+    // Saves the zones recorded so far, from all threads.
+    bool writeChromeTrace(const juce::File& file);
+
+    // Forgets the recorded zones. No thread may be recording.
+    void clear() noexcept;
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_REGISTER_THREAD() Trace::registerThread()
+
+#else
+
+#define TRACE_SCOPE(name)
+#define TRACE_REGISTER_THREAD()
+
+#endif
@@ -0,0 +1,360 @@
+#include "helpers/reference_processor.h"
+#include <catch2/catch_test_macros.hpp>
+#include <complex>
+
+// Renders the same signal through PluginProcessor and ReferenceProcessor and
+// compares them. The processor's optimisations (block reads, the fused SIMD
+// filter, kernel dispatch, reduced-precision storage) must not change what
+// comes out beyond the tolerances below.
+
+namespace
+{
+const double sampleRate = 48000.0;
+
+// What the delay history's storage format costs, in dB below full scale.
+// Float storage only differs from the reference by rounding in the filters.
+constexpr float storageTolerance()
+{
+    using Storage = DelayLine::Storage;
+    if constexpr (std::is_same_v<Storage, Float32Storage>)
+        return -100.0f;
+    else if constexpr (std::is_same_v<Storage, Int16Storage>)
+        return -80.0f;
+    else if constexpr (std::is_same_v<Storage, Float16Storage>)
+        return -55.0f;
+    else
+        return -35.0f;
+}
+
+// number of representable floats between a and b
+int64_t ulpDistance (float a, float b)
+{
+    auto ordered = [] (float x) {
+        auto bits = int64_t (std::bit_cast<int32_t> (x));
+        return bits < 0 ? int64_t (std::numeric_limits<int32_t>::min()) - bits : bits;
+    };
+    return std::abs (ordered (a) - ordered (b));
+}
+
+void setParameter (PluginProcessor& plugin, const juce::ParameterID& id, float value)
+{
+    auto* parameter = plugin.apvts.getParameter (id.getParamID());
+    parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+}
+
+struct Difference
+{
+    float peakErrorDecibels = -200.0f;  // worst sample, relative to full scale
+    int64_t maxUlps = 0;                // worst sample, in units in the last place
+};
+
+// Generates block after block of input, lets `automate` move parameters
+// before each one, and runs both processors on it.
+Difference render (PluginProcessor& plugin, int numChannels, int blockSize, int numBlocks,
+    const std::function<float (int channel, int64_t sample)>& signal,
+    const std::function<void (int block)>& automate = [] (int) {})
+{
+    plugin.prepareToPlay (sampleRate, blockSize);
+    ReferenceProcessor reference (plugin.apvts);
+    reference.prepare (sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer (numChannels, blockSize), expected (numChannels, blockSize);
+    juce::MidiBuffer midi;
+    Difference difference;
+    float peakError = 0.0f;
+    int64_t position = 0;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        automate (block);
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int sample = 0; sample < blockSize; ++sample)
+                buffer.setSample (channel, sample, signal (channel, position + sample));
+        expected.makeCopyOf (buffer, true);
+
+        plugin.processBlock (buffer, midi);
+        reference.process (expected, numChannels > 1);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int sample = 0; sample < blockSize; ++sample)
+            {
+                float actual = buffer.getSample (channel, sample);
+                float wanted = expected.getSample (channel, sample);
+                peakError = std::max (peakError, std::abs (actual - wanted));
+                difference.maxUlps = std::max (difference.maxUlps, ulpDistance (actual, wanted));
+            }
+        }
+        position += blockSize;
+    }
+
+    difference.peakErrorDecibels = juce::Decibels::gainToDecibels (peakError, -200.0f);
+    return difference;
+}
+
+float impulse (int, int64_t sample)
+{
+    return sample == 0 ? 0.5f : 0.0f;
+}
+
+float sweep (int channel, int64_t sample)
+{
+    // 20 Hz to 20 kHz over 2 seconds, the right channel a little quieter
+    const double duration = 2.0, f0 = 20.0, f1 = 20000.0;
+    double t = std::fmod (double (sample) / sampleRate, duration);
+    double k = std::log (f1 / f0) / duration;
+    double phase = juce::MathConstants<double>::twoPi * f0 * (std::exp (k * t) - 1.0) / k;
+    return float (std::sin (phase)) * (channel == 0 ? 0.4f : 0.3f);
+}
+
+float noise (int channel, int64_t sample)
+{
+    // a few seconds of white noise, made once and looped
+    static const auto samples = [] {
+        std::vector<float> values (size_t (2 * 3 * sampleRate));
+        juce::Random random (1234);
+        for (auto& value : values)
+            value = (random.nextFloat() * 2.0f - 1.0f) * 0.3f;
+        return values;
+    }();
+    return samples[size_t (sample * 2 + channel) % samples.size()];
+}
+}
+
+TEST_CASE ("Conformance without feedback is exact to a few ULP", "[conformance]")
+{
+    // With no feedback the filters are out of the loop, so the only
+    // difference left is the storage format.
+    PluginProcessor plugin;
+    setParameter (plugin, feedbackParamID, 0.0f);
+    setParameter (plugin, delayTimeParamID, 20.0f);
+    setParameter (plugin, mixParamID, 70.0f);
+
+    for (int blockSize : { 64, 480 })
+    {
+        auto difference = render (plugin, 2, blockSize, 100, noise);
+        INFO ("block size " << blockSize << ": " << difference.maxUlps << " ULP, "
+                            << difference.peakErrorDecibels << " dB");
+        if constexpr (std::is_same_v<DelayLine::Storage, Float32Storage>)
+            CHECK (difference.maxUlps <= 4);
+        else
+            CHECK (difference.peakErrorDecibels < storageTolerance());
+    }
+}
+
+TEST_CASE ("Conformance with feedback and filters", "[conformance]")
+{
+    PluginProcessor plugin;
+    setParameter (plugin, feedbackParamID, 70.0f);
+    setParameter (plugin, stereoParamID, -40.0f);
+    setParameter (plugin, lowCutParamID, 150.0f);
+    setParameter (plugin, highCutParamID, 6000.0f);
+
+    SECTION ("impulse")
+    {
+        setParameter (plugin, delayTimeParamID, 10.0f);  // shorter than a block
+        auto difference = render (plugin, 2, 256, 400, impulse);
+        INFO (difference.peakErrorDecibels << " dB");
+        CHECK (difference.peakErrorDecibels < storageTolerance());
+    }
+
+    SECTION ("sweep")
+    {
+        setParameter (plugin, delayTimeParamID, 125.0f);
+        auto difference = render (plugin, 2, 512, 400, sweep);
+        INFO (difference.peakErrorDecibels << " dB");
+        CHECK (difference.peakErrorDecibels < storageTolerance());
+    }
+
+    SECTION ("noise, mono")
+    {
+        juce::AudioProcessor::BusesLayout mono;
+        mono.inputBuses.add (juce::AudioChannelSet::mono());
+        mono.outputBuses.add (juce::AudioChannelSet::mono());
+        REQUIRE (plugin.setBusesLayout (mono));
+
+        setParameter (plugin, delayTimeParamID, 33.3f);  // not a whole number of samples
+        auto difference = render (plugin, 1, 128, 400, noise);
+        INFO (difference.peakErrorDecibels << " dB");
+        CHECK (difference.peakErrorDecibels < storageTolerance());
+    }
+}
+
+TEST_CASE ("Conformance under automation", "[conformance]")
+{
+    PluginProcessor plugin;
+    setParameter (plugin, delayTimeParamID, 100.0f);
+    setParameter (plugin, feedbackParamID, 50.0f);
+
+    // Ramps every parameter the reference models, jumps the delay time
+    // (which ducks), switches tempo sync and bypass on and off, and brings
+    // in the drive halfway through.
+    auto automate = [&] (int block) {
+        float ramp = float (block % 100) / 100.0f;
+        setParameter (plugin, gainParamID, -6.0f + 9.0f * ramp);  // stays clear of the output guard
+        setParameter (plugin, mixParamID, 100.0f * (1.0f - ramp));
+        setParameter (plugin, feedbackParamID, -50.0f + 100.0f * ramp);
+        setParameter (plugin, stereoParamID, -100.0f + 200.0f * ramp);
+        setParameter (plugin, lowCutParamID, 20.0f + 500.0f * ramp);
+        setParameter (plugin, highCutParamID, 18000.0f - 15000.0f * ramp);
+        if (block % 150 == 0)
+            setParameter (plugin, delayTimeParamID, block % 300 == 0 ? 100.0f : 180.5f);
+        setParameter (plugin, tempoSyncParamID, block % 400 >= 300 ? 1.0f : 0.0f);
+        setParameter (plugin, delayNoteParamID, 6.0f);  // 1/8 at the default 120 BPM
+        setParameter (plugin, bypassParamID, block % 250 >= 230 ? 1.0f : 0.0f);
+        setParameter (plugin, driveParamID, block >= 600 ? 80.0f * ramp : 0.0f);
+    };
+
+    auto difference = render (plugin, 2, 256, 1200, sweep, automate);
+    INFO (difference.peakErrorDecibels << " dB");
+    CHECK (difference.peakErrorDecibels < storageTolerance());
+}
+
+TEST_CASE ("Conformance of the double precision path", "[conformance]")
+{
+    // the same processor run in both precisions, side by side
+    PluginProcessor single, twice;
+    twice.setProcessingPrecision (juce::AudioProcessor::doublePrecision);
+    for (auto* plugin : { &single, &twice })
+    {
+        setParameter (*plugin, feedbackParamID, 80.0f);
+        setParameter (*plugin, delayTimeParamID, 12.5f);
+        setParameter (*plugin, highCutParamID, 8000.0f);
+        plugin->prepareToPlay (sampleRate, 256);
+    }
+
+    juce::AudioBuffer<float> floatBuffer (2, 256);
+    juce::AudioBuffer<double> doubleBuffer (2, 256);
+    juce::MidiBuffer midi;
+    float peakError = 0.0f;
+    for (int block = 0; block < 400; ++block)
+    {
+        for (int channel = 0; channel < 2; ++channel)
+            for (int sample = 0; sample < 256; ++sample)
+                floatBuffer.setSample (channel, sample, sweep (channel, block * 256 + sample));
+        doubleBuffer.makeCopyOf (floatBuffer, true);
+
+        single.processBlock (floatBuffer, midi);
+        twice.processBlock (doubleBuffer, midi);
+
+        for (int channel = 0; channel < 2; ++channel)
+            for (int sample = 0; sample < 256; ++sample)
+                peakError = std::max (peakError, float (std::abs (doubleBuffer.getSample (channel, sample)
+                                                                  - floatBuffer.getSample (channel, sample))));
+    }
+
+    // the double path keeps its history in doubles, whatever the float one uses
+    float errorDecibels = juce::Decibels::gainToDecibels (peakError, -200.0f);
+    INFO (errorDecibels << " dB");
+    CHECK (errorDecibels < storageTolerance());
+}
+
+TEST_CASE ("Small-signal response of the feedback loop", "[conformance]")
+{
+    // With no drive the loop is the filters and nothing else: each echo is
+    // the one before it through the low cut and high cut, times the
+    // feedback. Nothing else may colour it, at any frequency.
+    PluginProcessor plugin;
+    juce::AudioProcessor::BusesLayout mono;
+    mono.inputBuses.add (juce::AudioChannelSet::mono());
+    mono.outputBuses.add (juce::AudioChannelSet::mono());
+    REQUIRE (plugin.setBusesLayout (mono));
+
+    const int delay = 2400;  // 50 ms, long enough for the filters to ring out
+    const float feedback = 0.5f;
+    setParameter (plugin, delayTimeParamID, 50.0f);
+    setParameter (plugin, feedbackParamID, feedback * 100.0f);
+    setParameter (plugin, lowCutParamID, 500.0f);
+    setParameter (plugin, highCutParamID, 20000.0f);
+    setParameter (plugin, driveParamID, 0.0f);
+    plugin.prepareToPlay (sampleRate, delay);
+
+    juce::AudioBuffer<float> buffer (1, delay);
+    juce::MidiBuffer midi;
+    std::vector<float> echoes;
+    for (int block = 0; block < 3; ++block)
+    {
+        buffer.clear();
+        if (block == 0)
+            buffer.setSample (0, 0, 0.5f);
+        plugin.processBlock (buffer, midi);
+        echoes.insert (echoes.end(), buffer.getReadPointer (0), buffer.getReadPointer (0) + delay);
+    }
+
+    // what the two filters do to an impulse
+    juce::dsp::StateVariableTPTFilter<float> lowCutFilter, highCutFilter;
+    lowCutFilter.setType (juce::dsp::StateVariableTPTFilterType::highpass);
+    highCutFilter.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
+    for (auto* filter : { &lowCutFilter, &highCutFilter })
+        filter->prepare ({ sampleRate, juce::uint32 (delay), 1 });
+    lowCutFilter.setCutoffFrequency (500.0f);
+    highCutFilter.setCutoffFrequency (20000.0f);
+    std::vector<float> filtered (size_t (delay));
+    for (int n = 0; n < delay; ++n)
+        filtered[size_t (n)] = highCutFilter.processSample (0, lowCutFilter.processSample (0, n == 0 ? 1.0f : 0.0f));
+
+    auto magnitude = [] (const float* data, int numSamples, double frequency) {
+        std::complex<double> sum;
+        for (int n = 0; n < numSamples; ++n)
+            sum += double (data[n]) * std::polar (1.0, -juce::MathConstants<double>::twoPi * frequency * n / sampleRate);
+        return std::abs (sum);
+    };
+
+    for (double frequency : { 1000.0, 5000.0, 10000.0, 15000.0, 20000.0 })
+    {
+        double first = magnitude (echoes.data() + delay, delay, frequency);
+        double second = magnitude (echoes.data() + 2 * delay, delay, frequency);
+        double expected = feedback * magnitude (filtered.data(), delay, frequency);
+        double errorDecibels = 20.0 * std::log10 (second / first / expected);
+        INFO (frequency << " Hz: " << errorDecibels << " dB");
+        CHECK (std::abs (errorDecibels) < 0.5);
+    }
+}
+
+TEST_CASE ("Low rate feedback keeps the echoes in place", "[conformance]")
+{
+    // The resamplers add latency and the loop closes a whole low rate
+    // sample later, both of which the low rate path makes up for. A pulse
+    // well below the high cut comes back at the same samples either way.
+    const int delay = 2400;  // 50 ms
+    const int blockSize = 480;
+    auto pulse = [] (int sample) {
+        float x = float (sample - 200) / 40.0f;
+        return 0.5f * std::exp (-0.5f * x * x);
+    };
+
+    auto render = [&] (bool lowRate) {
+        PluginProcessor plugin;
+        setParameter (plugin, delayTimeParamID, 50.0f);
+        setParameter (plugin, feedbackParamID, 50.0f);
+        setParameter (plugin, mixParamID, 100.0f);
+        setParameter (plugin, highCutParamID, 1000.0f);  // low enough to run at 1/8
+        setParameter (plugin, lowRateParamID, lowRate ? 1.0f : 0.0f);
+        plugin.prepareToPlay (sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        juce::MidiBuffer midi;
+        std::vector<float> output;
+        for (int start = 0; start < 3 * delay; start += blockSize)
+        {
+            for (int channel = 0; channel < 2; ++channel)
+                for (int sample = 0; sample < blockSize; ++sample)
+                    buffer.setSample (channel, sample, pulse (start + sample));
+            plugin.processBlock (buffer, midi);
+            output.insert (output.end(), buffer.getReadPointer (0), buffer.getReadPointer (0) + blockSize);
+        }
+        return output;
+    };
+
+    auto peakNear = [] (const std::vector<float>& output, int centre) {
+        auto begin = output.begin() + centre - 200;
+        return int (std::max_element (begin, begin + 400) - output.begin());
+    };
+
+    auto fullRateOutput = render (false);
+    auto lowRateOutput = render (true);
+    CHECK (peakNear (fullRateOutput, 200 + delay) == 200 + delay);
+    CHECK (peakNear (lowRateOutput, 200 + delay) == peakNear (fullRateOutput, 200 + delay));
+    // the second echo has been through filters running at different rates
+    CHECK (std::abs (peakNear (lowRateOutput, 200 + 2 * delay) - peakNear (fullRateOutput, 200 + 2 * delay)) <= 1);
+}
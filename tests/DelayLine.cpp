@@ -0,0 +1,159 @@
+#include <DelayLine.h>
+#include <catch2/catch_test_macros.hpp>
+
+// what a sample reads back as after a trip through the delay line's storage
+static float stored (float x)
+{
+    return DelayLine::Storage::decode (DelayLine::Storage::encode (x));
+}
+
+TEST_CASE ("DelayLine read regions", "[delayline]")
+{
+    DelayLine delayLine;
+    delayLine.setMaximumDelayInSamples (100);
+    delayLine.reset();
+
+    // fill the ring past its length so the block read has to wrap around
+    float value = 1.0f;
+    for (int i = 0; i < 230; ++i)
+        delayLine.write (value++);
+
+    for (int delay : { 1, 17, 64, 100 })
+    {
+        SECTION ("delay " + std::to_string (delay))
+        {
+            const int numSamples = 64;
+            DelayLine::ReadRegions regions;
+            REQUIRE (delayLine.getReadRegions (delay, numSamples, regions));
+            REQUIRE (regions.first.size() + regions.second.size() == size_t (numSamples));
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                delayLine.write (value++);
+                CHECK (regions[size_t (sample)] == delayLine.read (float (delay)));
+            }
+        }
+    }
+
+    SECTION ("out of range")
+    {
+        DelayLine::ReadRegions regions;
+        CHECK_FALSE (delayLine.getReadRegions (delayLine.getBufferLength(), 16, regions));
+        CHECK_FALSE (delayLine.getReadRegions (-1, 16, regions));
+    }
+}
+
+TEST_CASE ("DelayLine growing keeps history", "[delayline]")
+{
+    DelayLine delayLine;
+    delayLine.setMaximumDelayInSamples (50);
+    delayLine.reset();
+
+    int count = 0;
+    auto write = [&] (int numSamples) {
+        for (int i = 0; i < numSamples; ++i)
+            delayLine.write (float (++count) * 0.01f);
+    };
+    // background thread and audio thread taking turns
+    auto grow = [&] (int numWrittenWhileCopying) {
+        delayLine.allocateRequestedBuffer();  // allocates
+        delayLine.swapInRequestedBuffer();  // notes where the history ends
+        write (numWrittenWhileCopying / 2);
+        delayLine.allocateRequestedBuffer();  // copies up to there
+        write (numWrittenWhileCopying - numWrittenWhileCopying / 2);
+        delayLine.swapInRequestedBuffer();  // adds the rest and swaps
+    };
+    auto checkHistory = [&] (int numSamples) {
+        // the newest samples survive, anything older reads as silence
+        for (int delay = 0; delay < numSamples; ++delay)
+            CHECK (delayLine.read (float (delay)) == stored (float (count - delay) * 0.01f));
+        CHECK (delayLine.read (float (numSamples + 10)) == 0.0f);
+    };
+    write (75);
+    delayLine.requestMaximumDelayInSamples (200);
+
+    SECTION ("with nothing written while copying")
+    {
+        grow (0);
+        REQUIRE (delayLine.getMaximumDelayInSamples() == 200);
+        checkHistory (52);
+
+        write (1);
+        CHECK (delayLine.read (0.0f) == stored (0.76f));
+        CHECK (delayLine.read (1.0f) == stored (0.75f));
+    }
+
+    SECTION ("with a few samples written while copying")
+    {
+        // they land on the oldest samples of the old ring
+        grow (10);
+        REQUIRE (delayLine.getMaximumDelayInSamples() == 200);
+        checkHistory (52);
+        write (100);
+        checkHistory (150);
+    }
+
+    SECTION ("after a reset while copying")
+    {
+        delayLine.allocateRequestedBuffer();
+        delayLine.swapInRequestedBuffer();
+        delayLine.allocateRequestedBuffer();
+        delayLine.reset();
+        write (5);
+        delayLine.swapInRequestedBuffer();
+        REQUIRE (delayLine.getMaximumDelayInSamples() == 200);
+        checkHistory (5);
+    }
+
+    SECTION ("the ring went round while copying")
+    {
+        grow (60);
+        CHECK (delayLine.getMaximumDelayInSamples() == 50);  // copies again
+        delayLine.allocateRequestedBuffer();
+        delayLine.swapInRequestedBuffer();
+        REQUIRE (delayLine.getMaximumDelayInSamples() == 200);
+        checkHistory (52);
+    }
+
+    SECTION ("prepareToPlay drops a request in flight")
+    {
+        delayLine.allocateRequestedBuffer();
+        delayLine.swapInRequestedBuffer();
+        delayLine.setMaximumDelayInSamples (100);
+        delayLine.allocateRequestedBuffer();
+        delayLine.swapInRequestedBuffer();
+        CHECK (delayLine.getMaximumDelayInSamples() == 100);
+    }
+
+    SECTION ("nothing more to do once the buffer is large enough")
+    {
+        grow (0);
+        delayLine.requestMaximumDelayInSamples (150);
+        grow (0);
+        CHECK (delayLine.getMaximumDelayInSamples() == 200);
+    }
+}
+
+TEST_CASE ("DelayLine reset reads as silence", "[delayline]")
+{
+    DelayLine delayLine;
+    delayLine.setMaximumDelayInSamples (100);
+    delayLine.reset();
+
+    for (int i = 0; i < 300; ++i)
+        delayLine.write (1.0f);
+
+    // the old samples are still in memory, but must not be heard
+    delayLine.reset();
+    for (float delay : { 1.0f, 2.5f, 50.0f, 99.75f })
+        CHECK (delayLine.read (delay) == 0.0f);
+
+    DelayLine::ReadRegions regions;
+    CHECK_FALSE (delayLine.getReadRegions (10, 16, regions));
+
+    delayLine.write (0.5f);
+    delayLine.write (0.25f);
+    CHECK (delayLine.read (1.0f) == stored (0.5f));
+    CHECK (delayLine.read (2.0f) == 0.0f);
+    CHECK (delayLine.read (3.0f) == 0.0f);
+}
@@ -0,0 +1,38 @@
+#include <DiagnosticLog.h>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE ("DiagnosticLog", "[diagnostics]")
+{
+    DiagnosticLog log;
+    juce::StringArray lines;
+    auto collect = [&] (const juce::String& line) { lines.add (line); };
+
+    SECTION ("records come out formatted and in order")
+    {
+        log.push ("first");
+        log.push ("second %g", 1.5f);
+        log.push ("third %g and %g", 2.0f, -3.0f);
+        log.drain (collect);
+
+        REQUIRE (lines.size() == 3);
+        CHECK (lines[0].endsWith (" first"));
+        CHECK (lines[1].endsWith (" second 1.5"));
+        CHECK (lines[2].endsWith (" third 2 and -3"));
+
+        lines.clear();
+        log.drain (collect);
+        CHECK (lines.isEmpty());
+    }
+
+    SECTION ("a full ring drops records instead of blocking")
+    {
+        for (int i = 0; i < DiagnosticLog::capacity + 10; ++i)
+            log.push ("event %g", float (i));
+        log.drain (collect);
+
+        REQUIRE (lines.size() > 1);
+        CHECK (lines[0].startsWith ("1"));
+        CHECK (lines[0].contains ("dropped"));
+        CHECK (lines[1].endsWith (" event 0"));
+    }
+}
@@ -0,0 +1,86 @@
+#include <FeedbackFilter.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+
+TEST_CASE ("FeedbackFilter matches the JUCE filters", "[feedbackfilter]")
+{
+    const double sampleRate = 48000.0;
+
+    juce::dsp::StateVariableTPTFilter<float> lowCutFilter, highCutFilter;
+    lowCutFilter.setType (juce::dsp::StateVariableTPTFilterType::highpass);
+    highCutFilter.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
+    juce::dsp::ProcessSpec spec { sampleRate, 512, 2 };
+    lowCutFilter.prepare (spec);
+    highCutFilter.prepare (spec);
+
+    FeedbackFilter filter;
+    filter.prepare (sampleRate);
+
+    juce::Random random (1234);
+    for (int sample = 0; sample < 4800; ++sample)
+    {
+        // move the cutoffs now and then, like the parameters would
+        if (sample % 1000 == 0)
+        {
+            float lowCut = 20.0f + random.nextFloat() * 980.0f;
+            float highCut = 1000.0f + random.nextFloat() * 19000.0f;
+            lowCutFilter.setCutoffFrequency (lowCut);
+            highCutFilter.setCutoffFrequency (highCut);
+            filter.setLowCut (lowCut);
+            filter.setHighCut (highCut);
+        }
+
+        float left = random.nextFloat() * 2.0f - 1.0f;
+        float right = random.nextFloat() * 2.0f - 1.0f;
+        float expectedL = highCutFilter.processSample (0, lowCutFilter.processSample (0, left));
+        float expectedR = highCutFilter.processSample (1, lowCutFilter.processSample (1, right));
+
+        filter.process (left, right);
+        CHECK (std::abs (left - expectedL) < 1e-4f);
+        CHECK (std::abs (right - expectedR) < 1e-4f);
+    }
+}
+
+TEST_CASE ("FeedbackFilter at 0 Hz", "[feedbackfilter]")
+{
+    // The High Cut parameter goes down to 0 Hz. Low Cut stops at 20 Hz,
+    // but the filter must take 0 Hz for its low cut as well.
+    const double sampleRate = 48000.0;
+    FeedbackFilter filter;
+    filter.prepare (sampleRate);
+
+    SECTION ("low cut at 0 Hz lets everything through")
+    {
+        filter.setLowCut (0.0f);
+        filter.setHighCut (20000.0f);
+        juce::dsp::StateVariableTPTFilter<float> highCutFilter;
+        highCutFilter.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
+        highCutFilter.prepare ({ sampleRate, 512, 2 });
+        highCutFilter.setCutoffFrequency (20000.0f);
+
+        juce::Random random (1234);
+        for (int sample = 0; sample < 1000; ++sample)
+        {
+            float left = random.nextFloat() * 2.0f - 1.0f;
+            float right = random.nextFloat() * 2.0f - 1.0f;
+            float expectedL = highCutFilter.processSample (0, left);
+            float expectedR = highCutFilter.processSample (1, right);
+            filter.process (left, right);
+            CHECK (std::abs (left - expectedL) < 1e-4f);
+            CHECK (std::abs (right - expectedR) < 1e-4f);
+        }
+    }
+
+    SECTION ("high cut at 0 Hz lets nothing through")
+    {
+        filter.setLowCut (20.0f);
+        filter.setHighCut (0.0f);
+        for (int sample = 0; sample < 1000; ++sample)
+        {
+            float left = 1.0f, right = -1.0f;
+            filter.process (left, right);
+            CHECK (left == 0.0f);
+            CHECK (right == 0.0f);
+        }
+    }
+}
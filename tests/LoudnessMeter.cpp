@@ -0,0 +1,47 @@
+#include <LoudnessMeter.h>
+#include <catch2/catch_test_macros.hpp>
+
+// Runs seconds of a sine through the meter, a block at a time, with process()
+// called after every block instead of on the background thread.
+static void runSine (LoudnessMeter& meter, double sampleRate, float amplitude, double frequency,
+                     double phase, bool stereo, double seconds)
+{
+    meter.prepare (sampleRate);
+    std::vector<float> block (512);
+    long n = 0;
+    for (int b = 0; b < int (seconds * sampleRate / 512.0); ++b)
+    {
+        for (auto& sample : block)
+            sample = amplitude * float (std::sin (juce::MathConstants<double>::twoPi * frequency * double (n++) / sampleRate + phase));
+        meter.push (block.data(), stereo ? block.data() : nullptr, int (block.size()));
+        meter.process();
+    }
+}
+
+TEST_CASE ("LoudnessMeter", "[loudness]")
+{
+    LoudnessMeter meter;
+
+    SECTION ("a 1 kHz sine at -20 dBFS in both channels reads -20 LUFS")
+    {
+        for (double sampleRate : { 44100.0, 48000.0, 96000.0 })
+        {
+            runSine (meter, sampleRate, 0.1f, 997.0, 0.0, true, 4.0);
+            CHECK (std::abs (meter.getMomentaryLoudness() + 20.0f) < 0.1f);
+            CHECK (std::abs (meter.getShortTermLoudness() + 20.0f) < 0.1f);
+        }
+    }
+
+    SECTION ("true peak finds the peaks between samples")
+    {
+        // at a quarter of the sample rate, shifted 45 degrees, every sample
+        // misses the peak by 3 dB
+        runSine (meter, 48000.0, 0.5f, 12000.0, juce::MathConstants<double>::pi / 4.0, false, 1.0);
+        CHECK (meter.getTruePeak() > -6.3f);
+        CHECK (meter.getTruePeak() < -5.9f);
+
+        meter.resetTruePeak();
+        meter.process();
+        CHECK (meter.getTruePeak() == LoudnessMeter::silence);
+    }
+}
@@ -0,0 +1,72 @@
+#include <Kernels.h>
+#include <ProtectYourEars.h>
+#include <catch2/catch_test_macros.hpp>
+#include <limits>
+
+static uint32_t peakBits (const juce::AudioBuffer<float>& buffer)
+{
+    uint32_t result = 0;
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        result = std::max (result, Kernels::select().peakBits (buffer.getReadPointer (channel), buffer.getNumSamples()));
+    return result;
+}
+
+TEST_CASE ("OutputGuard", "[outputguard]")
+{
+    OutputGuard guard;
+    juce::AudioBuffer<float> buffer (2, 64);
+
+    SECTION ("normal audio passes")
+    {
+        buffer.clear();
+        buffer.setSample (0, 10, 1.5f);
+        buffer.setSample (1, 20, -3.9f);  // hot, but within the +12 dB of output gain
+        REQUIRE_FALSE (guard.process (buffer, peakBits (buffer)));
+        CHECK (buffer.getSample (0, 10) == 1.5f);
+        CHECK (buffer.getSample (1, 20) == -3.9f);
+        CHECK (guard.getGain() == 1.0f);
+        CHECK (guard.getNumTrips() == 0);
+    }
+
+    SECTION ("loud audio is turned down, not silenced")
+    {
+        buffer.clear();
+        buffer.setSample (0, 40, 10.0f);
+        REQUIRE_FALSE (guard.process (buffer, peakBits (buffer)));
+        CHECK (std::abs (buffer.getSample (0, 40) - OutputGuard::limitLevel) < 1e-5f);
+        CHECK (guard.getNumTrips() == 0);
+
+        // and comes back up over the following blocks
+        float lastGain = guard.getGain();
+        for (int block = 0; block < 20; ++block)
+        {
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+                buffer.setSample (0, sample, 0.5f);
+            REQUIRE_FALSE (guard.process (buffer, peakBits (buffer)));
+            CHECK (guard.getGain() >= lastGain);
+            lastGain = guard.getGain();
+        }
+        CHECK (lastGain == 1.0f);
+        CHECK (buffer.getSample (0, 10) == 0.5f);
+    }
+
+    SECTION ("absurdly loud, infinite or NaN is silenced")
+    {
+        for (float bad : { -300.0f, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN() })
+        {
+            buffer.clear();
+            buffer.setSample (1, 33, bad);
+            REQUIRE (guard.process (buffer, peakBits (buffer)));
+            CHECK (buffer.getMagnitude (0, buffer.getNumSamples()) == 0.0f);
+        }
+        CHECK (guard.getNumTrips() == 2);
+        CHECK (guard.getNumNaNs() == 1);
+
+        // the next block fades back in
+        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            buffer.setSample (0, sample, 1.0f);
+        REQUIRE_FALSE (guard.process (buffer, peakBits (buffer)));
+        CHECK (buffer.getSample (0, 0) == 0.0f);
+        CHECK (buffer.getSample (0, 32) < 1.0f);
+    }
+}
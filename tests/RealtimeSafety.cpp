@@ -0,0 +1,243 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <thread>
+
+#if defined(__GLIBC__)
+    #include <dlfcn.h>
+    #include <pthread.h>
+#endif
+
+// Catches allocations and locks on the audio thread. While a RealtimeCheck
+// is alive on a thread, every operator new and delete made on that thread
+// is recorded as a violation with a stack trace. On glibc, malloc, calloc,
+// realloc, free and pthread_mutex_lock are caught as well (std::mutex and
+// juce::CriticalSection both end up in pthread_mutex_lock).
+//
+// These replace the global functions for the whole test executable. Outside
+// a RealtimeCheck they only forward to the real ones.
+
+namespace
+{
+thread_local bool checking = false;
+juce::StringArray violations;  // only touched by the checked thread
+
+// Reports once per intercepted call, and switches the check off for any
+// calls the report or the real function make in turn.
+struct Intercept
+{
+    explicit Intercept (const char* function) : active (checking)
+    {
+        if (active)
+        {
+            checking = false;
+            violations.add (juce::String (function) + " on the audio thread\n" + juce::SystemStats::getStackBacktrace());
+        }
+    }
+    ~Intercept()
+    {
+        if (active)
+            checking = true;
+    }
+    bool active;
+};
+
+class RealtimeCheck
+{
+public:
+    RealtimeCheck() { checking = true; }
+    ~RealtimeCheck() { checking = false; }
+};
+}
+
+void* operator new (std::size_t size)
+{
+    Intercept intercept ("operator new");
+    if (void* p = std::malloc (size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[] (std::size_t size) { return operator new (size); }
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+    Intercept intercept ("operator new");
+    return std::malloc (size == 0 ? 1 : size);
+}
+void* operator new[] (std::size_t size, const std::nothrow_t& tag) noexcept { return operator new (size, tag); }
+void* operator new (std::size_t size, std::align_val_t alignment)
+{
+    Intercept intercept ("operator new");
+    auto align = static_cast<std::size_t> (alignment);
+    if (void* p = std::aligned_alloc (align, (std::max (size, std::size_t (1)) + align - 1) / align * align))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[] (std::size_t size, std::align_val_t alignment) { return operator new (size, alignment); }
+
+void operator delete (void* p) noexcept
+{
+    Intercept intercept ("operator delete");
+    std::free (p);
+}
+void operator delete[] (void* p) noexcept { operator delete (p); }
+void operator delete (void* p, std::size_t) noexcept { operator delete (p); }
+void operator delete[] (void* p, std::size_t) noexcept { operator delete (p); }
+void operator delete (void* p, std::align_val_t) noexcept { operator delete (p); }
+void operator delete[] (void* p, std::align_val_t) noexcept { operator delete (p); }
+void operator delete (void* p, std::size_t, std::align_val_t) noexcept { operator delete (p); }
+void operator delete[] (void* p, std::size_t, std::align_val_t) noexcept { operator delete (p); }
+
+#if defined(__GLIBC__)
+extern "C"
+{
+void* __libc_malloc (size_t);
+void* __libc_calloc (size_t, size_t);
+void* __libc_realloc (void*, size_t);
+void __libc_free (void*);
+
+void* malloc (size_t size) noexcept
+{
+    Intercept intercept ("malloc");
+    return __libc_malloc (size);
+}
+void* calloc (size_t count, size_t size) noexcept
+{
+    Intercept intercept ("calloc");
+    return __libc_calloc (count, size);
+}
+void* realloc (void* p, size_t size) noexcept
+{
+    Intercept intercept ("realloc");
+    return __libc_realloc (p, size);
+}
+void free (void* p) noexcept
+{
+    Intercept intercept ("free");
+    __libc_free (p);
+}
+
+int pthread_mutex_lock (pthread_mutex_t* mutex) noexcept
+{
+    using Function = int (*) (pthread_mutex_t*);
+    static auto real = reinterpret_cast<Function> (dlsym (RTLD_NEXT, "pthread_mutex_lock"));
+    Intercept intercept ("pthread_mutex_lock");
+    return real (mutex);
+}
+}
+#endif
+
+namespace
+{
+// a host that is playing, at a tempo the test can change
+class TestPlayHead : public juce::AudioPlayHead
+{
+public:
+    juce::Optional<PositionInfo> getPosition() const override
+    {
+        PositionInfo position;
+        position.setBpm (bpm);
+        position.setIsPlaying (true);
+        return position;
+    }
+    double bpm = 120.0;
+};
+
+void setParameter (PluginProcessor& plugin, const juce::ParameterID& id, float value)
+{
+    auto* parameter = plugin.apvts.getParameter (id.getParamID());
+    parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+}
+
+void failOnViolations()
+{
+    // the first few are enough, the traces are long
+    for (int i = 0; i < std::min (violations.size(), 5); ++i)
+        FAIL_CHECK (violations[i].toStdString());
+    CHECK (violations.isEmpty());
+    violations.clear();
+}
+}
+
+TEST_CASE ("The realtime check catches allocations and locks", "[realtime]")
+{
+    static std::unique_ptr<int> escaped;  // so the compiler can't leave out the allocation
+    violations.clear();
+    {
+        RealtimeCheck check;
+        escaped = std::make_unique<int> (1);
+        escaped.reset();
+    }
+    CHECK (violations.size() >= 2);  // the new and the delete
+    violations.clear();
+
+#if defined(__GLIBC__)
+    std::mutex mutex;
+    {
+        RealtimeCheck check;
+        mutex.lock();
+        mutex.unlock();
+    }
+    CHECK (violations.size() == 1);
+    violations.clear();
+#endif
+}
+
+TEST_CASE ("processBlock is realtime safe", "[realtime]")
+{
+    bool stereo = GENERATE (true, false);
+    INFO ((stereo ? "stereo" : "mono"));
+
+    PluginProcessor plugin;
+    if (! stereo)
+    {
+        juce::AudioProcessor::BusesLayout mono;
+        mono.inputBuses.add (juce::AudioChannelSet::mono());
+        mono.outputBuses.add (juce::AudioChannelSet::mono());
+        REQUIRE (plugin.setBusesLayout (mono));
+    }
+    TestPlayHead playHead;
+    plugin.setPlayHead (&playHead);
+    setParameter (plugin, feedbackParamID, 60.0f);
+    plugin.prepareToPlay (48000.0, 256);
+    plugin.spectrum.start();  // as if an editor were showing it
+
+    const int numChannels = stereo ? 2 : 1;
+    juce::AudioBuffer<float> buffer (numChannels, 256);
+    juce::MidiBuffer midi;
+    juce::Random random (42);
+
+    violations.clear();
+    for (int block = 0; block < 800; ++block)
+    {
+        // automation, tempo changes and switches, all between blocks
+        float ramp = float (block % 100) / 100.0f;
+        setParameter (plugin, gainParamID, -12.0f + 12.0f * ramp);
+        setParameter (plugin, mixParamID, 100.0f * ramp);
+        setParameter (plugin, stereoParamID, -100.0f + 200.0f * ramp);
+        setParameter (plugin, lowCutParamID, 20.0f + 1000.0f * ramp);
+        setParameter (plugin, highCutParamID, block % 200 < 100 ? 15000.0f : 3000.0f);
+        setParameter (plugin, tempoSyncParamID, block % 120 >= 60 ? 1.0f : 0.0f);
+        setParameter (plugin, delayNoteParamID, float (block / 60 % 16));
+        setParameter (plugin, bypassParamID, block % 90 >= 80 ? 1.0f : 0.0f);
+        setParameter (plugin, lowRateParamID, block >= 400 ? 1.0f : 0.0f);
+        playHead.bpm = block % 50 == 0 ? 60.0 + random.nextInt (120) : playHead.bpm;
+
+        // ask for more than was allocated, so the delay lines grow
+        if (block == 300)
+            setParameter (plugin, delayTimeParamID, 3000.0f);
+        if (block % 100 == 0)  // give the background thread a chance to run
+            std::this_thread::sleep_for (std::chrono::milliseconds (30));
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+                buffer.setSample (channel, sample, random.nextFloat() * 0.5f - 0.25f);
+
+        {
+            RealtimeCheck check;
+            plugin.processBlock (buffer, midi);
+        }
+    }
+
+    plugin.spectrum.stop();
+    failOnViolations();
+}
@@ -0,0 +1,57 @@
+#include <Resampler.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+
+// Sends a sine through the decimator and interpolator and returns the error
+// against the input delayed by the latency, in dB below the signal.
+static float roundTripError (int factor, float frequency)
+{
+    Decimator decimator;
+    Interpolator interpolator;
+    decimator.setFactor (factor);
+    interpolator.setFactor (factor);
+
+    const int latency = Resampling::getLatency (factor);
+    const float twoPi = 6.2831853f;
+    double signal = 0.0, error = 0.0;
+
+    for (int i = 0; i < 8192; ++i)
+    {
+        float input = std::sin (twoPi * frequency * float (i));
+        float low;
+        if (decimator.process (input, low))
+            interpolator.push (low);
+        float output = interpolator.process();
+
+        if (i >= 2048)
+        {
+            float expected = std::sin (twoPi * frequency * float (i - latency));
+            signal += double (expected * expected);
+            error += double ((output - expected) * (output - expected));
+        }
+    }
+    return float (10.0 * std::log10 (signal / error));
+}
+
+TEST_CASE ("Resampler round trip", "[resampler]")
+{
+    for (int factor : { 2, 4, 8 })
+    {
+        SECTION ("factor " + std::to_string (factor))
+        {
+            // a tone at a tenth of the low rate's Nyquist frequency
+            CHECK (roundTripError (factor, 0.05f / float (factor)) > 50.0f);
+        }
+    }
+
+    SECTION ("factor 1 passes through")
+    {
+        Decimator decimator;
+        Interpolator interpolator;
+        float low = 0.0f;
+        REQUIRE (decimator.process (0.5f, low));
+        CHECK (low == 0.5f);
+        interpolator.push (low);
+        CHECK (interpolator.process() == 0.5f);
+    }
+}
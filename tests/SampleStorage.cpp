@@ -0,0 +1,70 @@
+#include <SampleStorage.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+// Signal-to-noise ratio in dB of a 997 Hz sine at the given level after a
+// round trip through the storage format.
+template <typename Storage>
+static double noiseFloor (float level)
+{
+    const size_t numSamples = 48000;
+    std::vector<float> input (numSamples), output (numSamples);
+    std::vector<typename Storage::Type> stored (numSamples);
+
+    for (size_t i = 0; i < numSamples; ++i)
+        input[i] = level * float (std::sin (2.0 * std::numbers::pi * 997.0 * double (i) / 48000.0));
+
+    Storage::encode (input.data(), stored.data(), int (numSamples));
+    Storage::decode (stored.data(), output.data(), int (numSamples));
+
+    double signal = 0.0, noise = 0.0;
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        double error = double (output[i]) - double (input[i]);
+        signal += double (input[i]) * double (input[i]);
+        noise += error * error;
+    }
+    return noise > 0.0 ? 10.0 * std::log10 (signal / noise) : 200.0;
+}
+
+TEST_CASE ("Delay storage noise floor", "[storage]")
+{
+    // a loud echo at -6 dBFS and a quiet tail at -60 dBFS
+    for (float level : { 0.5f, 0.001f })
+    {
+        double float32 = noiseFloor<Float32Storage> (level);
+        double float16 = noiseFloor<Float16Storage> (level);
+        double bfloat16 = noiseFloor<BFloat16Storage> (level);
+        double int16 = noiseFloor<Int16Storage> (level);
+
+        WARN ("SNR at " << 20.0 * std::log10 (level) << " dBFS: float32 " << float32
+                        << " dB, float16 " << float16 << " dB, bfloat16 " << bfloat16
+                        << " dB, int16 " << int16 << " dB");
+
+        CHECK (float32 >= 200.0);
+        CHECK (float16 > 70.0);
+        CHECK (bfloat16 > 50.0);
+    }
+
+    // fixed point has a constant noise floor, so quiet tails get noisy
+    CHECK (noiseFloor<Int16Storage> (0.5f) > 80.0);
+    CHECK (noiseFloor<Int16Storage> (0.001f) > 30.0);
+}
+
+TEST_CASE ("Delay storage edge cases", "[storage]")
+{
+    CHECK (Float16Storage::decode (Float16Storage::encode (65504.0f)) == 65504.0f);
+    CHECK (Float16Storage::decode (Float16Storage::encode (1.0e5f)) > 65504.0f);  // infinity
+    CHECK (Float16Storage::decode (Float16Storage::encode (-2.5f)) == -2.5f);
+    CHECK (Float16Storage::decode (Float16Storage::encode (0.0f)) == 0.0f);
+    CHECK (std::abs (Float16Storage::decode (Float16Storage::encode (3.0e-6f)) - 3.0e-6f) < 6.0e-8f);
+
+    CHECK (BFloat16Storage::decode (BFloat16Storage::encode (1.0f)) == 1.0f);
+    CHECK (BFloat16Storage::decode (BFloat16Storage::encode (-0.25f)) == -0.25f);
+
+    CHECK (Int16Storage::decode (Int16Storage::encode (10.0f)) == Int16Storage::maxLevel);
+    CHECK (Int16Storage::decode (Int16Storage::encode (-10.0f)) == -Int16Storage::maxLevel);
+    CHECK (Int16Storage::decode (Int16Storage::encode (0.0f)) == 0.0f);
+}
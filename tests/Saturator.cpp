@@ -0,0 +1,157 @@
+#include <Saturator.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+
+// the antiderivative of the saturation curve, in double
+static double antiderivative (double x)
+{
+    double clipped = std::clamp (x, -1.5, 1.5);
+    return clipped * clipped / 2.0 - std::pow (clipped, 4.0) / 27.0 + std::abs (x) - std::abs (clipped);
+}
+
+// Power that lands outside the harmonics of a sine that sits exactly on
+// frequency bin `bin` of `numSamples`, relative to the total, in dB.
+static double aliasing (const std::vector<float>& output, int bin)
+{
+    const int numSamples = int (output.size());
+    double total = 0.0, aliased = 0.0;
+    for (int k = 1; k < numSamples / 2; ++k)
+    {
+        double re = 0.0, im = 0.0;
+        for (int n = 0; n < numSamples; ++n)
+        {
+            double phase = juce::MathConstants<double>::twoPi * double (k) * double (n) / double (numSamples);
+            re += double (output[size_t (n)]) * std::cos (phase);
+            im -= double (output[size_t (n)]) * std::sin (phase);
+        }
+        double power = re * re + im * im;
+        total += power;
+        if (k % bin != 0)
+            aliased += power;
+    }
+    return 10.0 * std::log10 (aliased / total);
+}
+
+TEST_CASE ("Saturator is the mean of the curve between samples", "[saturator]")
+{
+    Saturator saturator;
+    saturator.reset();
+
+    juce::Random random (1234);
+    double previousL = 0.0, previousR = 0.0;
+    for (int sample = 0; sample < 10000; ++sample)
+    {
+        // quiet, loud and far past the clip point
+        float range = sample < 3000 ? 0.2f : sample < 6000 ? 2.0f : 8.0f;
+        float left = (random.nextFloat() * 2.0f - 1.0f) * range;
+        float right = (random.nextFloat() * 2.0f - 1.0f) * range;
+        double expectedL = (antiderivative (left) - antiderivative (previousL)) / (left - previousL);
+        double expectedR = (antiderivative (right) - antiderivative (previousR)) / (right - previousR);
+        previousL = left;
+        previousR = right;
+
+        saturator.process (left, right);
+        CHECK (std::abs (left - expectedL) < 1e-5);
+        CHECK (std::abs (right - expectedR) < 1e-5);
+        CHECK (std::abs (left) <= 1.0f);
+        CHECK (std::abs (right) <= 1.0f);
+    }
+}
+
+TEST_CASE ("Saturator holds still on a constant input", "[saturator]")
+{
+    Saturator saturator;
+    saturator.reset();
+    for (float input : { 0.0f, 0.1f, -0.8f, 1.5f, 4.0f })
+    {
+        float left = input, right = -input;
+        saturator.process (left, right);
+        left = input;
+        right = -input;
+        saturator.process (left, right);
+        float expected = std::min (std::abs (input), 1.5f);
+        expected -= 4.0f * expected * expected * expected / 27.0f;
+        CHECK (std::abs (left - std::copysign (expected, input)) < 1e-6f);
+        CHECK (std::abs (right + std::copysign (expected, input)) < 1e-6f);
+    }
+}
+
+TEST_CASE ("Saturator drive", "[saturator]")
+{
+    Saturator saturator;
+    saturator.reset();
+    juce::Random random (99);
+
+    SECTION ("no drive is no change at all")
+    {
+        for (int sample = 0; sample < 1000; ++sample)
+        {
+            float x = random.nextFloat() * 4.0f - 2.0f;
+            float left = x, right = -x;
+            saturator.process (left, right, 0.0f);
+            CHECK (left == x);
+            CHECK (right == -x);
+        }
+    }
+
+    SECTION ("small signals keep their level at any drive")
+    {
+        for (float drive : { 0.1f, 0.5f, 1.0f })
+        {
+            saturator.reset();
+            float left = 0.0f, right = 0.0f;
+            for (int sample = 0; sample < 4; ++sample)
+            {
+                left = 0.001f;
+                right = -0.001f;
+                saturator.process (left, right, drive);
+            }
+            CHECK (std::abs (left - 0.001f) < 1e-6f);
+            CHECK (std::abs (right + 0.001f) < 1e-6f);
+        }
+    }
+
+    SECTION ("more drive, more squash")
+    {
+        float previous = 1.0f;
+        for (float drive : { 0.25f, 0.5f, 1.0f })
+        {
+            saturator.reset();
+            float left = 0.0f, right = 0.0f;
+            for (int sample = 0; sample < 4; ++sample)
+            {
+                left = right = 0.5f;
+                saturator.process (left, right, drive);
+            }
+            CHECK (left < previous);
+            previous = left;
+        }
+    }
+}
+
+TEST_CASE ("Saturator aliases less than plain waveshaping", "[saturator]")
+{
+    // a loud 14 kHz sine at 48 kHz, well into the clipping, so most of its
+    // harmonics fold back
+    const int numSamples = 1024, bin = 300;
+    Saturator saturator;
+    saturator.reset();
+    std::vector<float> plain, smoothed;
+    for (int n = 0; n < 2 * numSamples; ++n)
+    {
+        float x = 3.0f * float (std::sin (juce::MathConstants<double>::twoPi * bin * n / numSamples));
+        float left = x, right = x;
+        saturator.process (left, right);
+        if (n >= numSamples)
+        {
+            float clipped = std::clamp (x, -1.5f, 1.5f);
+            plain.push_back (clipped - 4.0f * clipped * clipped * clipped / 27.0f);
+            smoothed.push_back (left);
+        }
+    }
+
+    double plainAliasing = aliasing (plain, bin);
+    double smoothedAliasing = aliasing (smoothed, bin);
+    INFO ("plain " << plainAliasing << " dB, ADAA " << smoothedAliasing << " dB");
+    CHECK (smoothedAliasing < plainAliasing - 6.0);
+}
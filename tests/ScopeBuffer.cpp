@@ -0,0 +1,57 @@
+#include <ScopeBuffer.h>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE ("ScopeBuffer", "[scope]")
+{
+    ScopeBuffer scope;
+    scope.prepare (48000.0);  // 240 samples per point
+    std::array<ScopePoint, ScopeBuffer::capacity> points;
+
+    SECTION ("keeps the extremes of each stretch")
+    {
+        for (int sample = 0; sample < 480; ++sample)
+        {
+            float dry = sample == 100 ? 0.75f : 0.0f;
+            float wet = sample == 300 ? -0.5f : 0.0f;
+            scope.push (dry, wet);
+        }
+        REQUIRE (scope.read (points.data(), int (points.size())) == 2);
+        CHECK (points[0].dryMax == 0.75f);
+        CHECK (points[0].wetMin == 0.0f);
+        CHECK (points[1].dryMax == 0.0f);
+        CHECK (points[1].wetMin == -0.5f);
+        CHECK (scope.read (points.data(), int (points.size())) == 0);
+    }
+
+    SECTION ("drops points when nobody reads")
+    {
+        for (int sample = 0; sample < 240 * (ScopeBuffer::capacity + 100); ++sample)
+            scope.push (0.0f, 0.0f);
+        CHECK (scope.read (points.data(), int (points.size())) == ScopeBuffer::capacity - 1);
+    }
+
+    SECTION ("prepare leaves the old points for the reader to drop")
+    {
+        for (int sample = 0; sample < 240 * 3; ++sample)
+            scope.push (1.0f, 1.0f);
+        scope.prepare (96000.0);  // 480 samples per point
+        for (int sample = 0; sample < 480; ++sample)
+            scope.push (-0.25f, 0.0f);
+        REQUIRE (scope.read (points.data(), int (points.size())) == 1);
+        CHECK (points[0].dryMin == -0.25f);
+        CHECK (points[0].dryMax == -0.25f);
+    }
+
+    SECTION ("a one-sided signal doesn't reach zero")
+    {
+        for (int sample = 0; sample < 240; ++sample)
+        {
+            float dry = -0.5f - 0.25f * float (sample % 2);
+            scope.push (dry, 0.3f);
+        }
+        REQUIRE (scope.read (points.data(), int (points.size())) == 1);
+        CHECK (points[0].dryMax < 0.0f);
+        CHECK (points[0].dryMin == -0.75f);
+        CHECK (points[0].wetMin == 0.3f);
+    }
+}
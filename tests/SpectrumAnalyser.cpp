@@ -0,0 +1,21 @@
+#include <SpectrumAnalyser.h>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE ("SpectrumAnalyser finds a sine", "[spectrum]")
+{
+    SpectrumAnalyser analyser;
+    analyser.setSampleRate (48000.0);
+
+    // exactly on bin 64
+    const double frequency = 64.0 * 48000.0 / SpectrumAnalyser::fftSize;
+    for (int sample = 0; sample < SpectrumAnalyser::fftSize; ++sample)
+        analyser.push (float (std::sin (juce::MathConstants<double>::twoPi * frequency * sample / 48000.0)));
+    analyser.flush();
+    analyser.analyse();  // normally on the background thread
+
+    std::array<float, SpectrumAnalyser::numBins> magnitudes;
+    analyser.getMagnitudes (magnitudes);
+    auto peak = std::max_element (magnitudes.begin(), magnitudes.end());
+    CHECK (peak - magnitudes.begin() == 64);
+    CHECK (std::abs (*peak) < 1.0f);  // full scale reads 0 dB
+}
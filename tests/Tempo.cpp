@@ -0,0 +1,181 @@
+#include <PluginProcessor.h>
+#include <Tempo.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+namespace
+{
+// a host playing from sample 0, whose reported BPM can disagree with the
+// PPQ position it reports
+class TestPlayHead : public juce::AudioPlayHead
+{
+public:
+    juce::Optional<PositionInfo> getPosition() const override
+    {
+        PositionInfo position;
+        position.setBpm (bpm);
+        position.setPpqPosition (ppq);
+        position.setTimeInSamples (time);
+        position.setIsPlaying (playing);
+        return position;
+    }
+
+    // moves on by one block at the given tempo
+    void advance (int numSamples, double sampleRate, double tempo)
+    {
+        time += numSamples;
+        ppq += tempo / 60.0 * numSamples / sampleRate;
+    }
+
+    double bpm = 120.0;
+    double ppq = 0.0;
+    juce::int64 time = 0;
+    bool playing = true;
+};
+
+void setParameter (PluginProcessor& plugin, const juce::ParameterID& id, float value)
+{
+    auto* parameter = plugin.apvts.getParameter (id.getParamID());
+    parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+}
+}
+
+TEST_CASE ("Tempo sync note lengths", "[tempo]")
+{
+    Tempo tempo;
+    tempo.prepare (48000.0);
+    CHECK (tempo.getTempo() == 120.0);
+    CHECK (tempo.getSamplesForNoteLength (9) == 24000.0);  // 1/4
+    CHECK (tempo.getSamplesForNoteLength (6) == 12000.0);  // 1/8
+    CHECK (tempo.getMillisecondsForNoteLength (15) == 2000.0);  // 1/1
+}
+
+TEST_CASE ("Tempo follows the PPQ position while playing", "[tempo]")
+{
+    const double sampleRate = 48000.0;
+    Tempo tempo;
+    tempo.prepare (sampleRate);
+    TestPlayHead playHead;
+
+    SECTION ("the reported tempo is used until there is a block to measure")
+    {
+        playHead.bpm = 90.0;
+        tempo.update (&playHead, 512);
+        CHECK (tempo.getTempo() == 90.0);
+    }
+
+    SECTION ("the PPQ position wins over the reported tempo")
+    {
+        playHead.bpm = 100.0;  // stale, or rounded by the host
+        tempo.update (&playHead, 512);
+        for (int block = 0; block < 10; ++block)
+        {
+            playHead.advance (512, sampleRate, 137.0);
+            tempo.update (&playHead, 512);
+        }
+        CHECK_THAT (tempo.getTempo(), Catch::Matchers::WithinRel (137.0, 1e-4));
+        CHECK_THAT (tempo.getSamplesForNoteLength (9), Catch::Matchers::WithinRel (60.0 / 137.0 * sampleRate, 1e-4));
+    }
+
+    SECTION ("a jump in position is not a tempo")
+    {
+        playHead.bpm = 120.0;
+        tempo.update (&playHead, 512);
+        playHead.advance (512, sampleRate, 120.0);
+        playHead.ppq += 8.0;  // the host looped
+        playHead.time += 48000;
+        tempo.update (&playHead, 512);
+        CHECK (tempo.getTempo() == 120.0);
+    }
+
+    SECTION ("the last tempo stays when the host stops reporting one")
+    {
+        playHead.bpm = 80.0;
+        tempo.update (&playHead, 512);
+        tempo.update (nullptr, 512);
+        CHECK (tempo.getTempo() == 80.0);
+    }
+}
+
+TEST_CASE ("Tempo ignores jitter", "[tempo]")
+{
+    Tempo tempo;
+    tempo.prepare (44100.0);
+    TestPlayHead playHead;
+    playHead.playing = false;
+
+    playHead.bpm = 120.0;
+    tempo.update (&playHead, 256);
+    double length = tempo.getSamplesForNoteLength (6);
+
+    // the kind of wobble a host's tempo has in float
+    for (double bpm : { 120.0001, 119.9999, 120.005, 119.995 })
+    {
+        playHead.bpm = bpm;
+        tempo.update (&playHead, 256);
+        CHECK (tempo.getSamplesForNoteLength (6) == length);
+    }
+
+    playHead.bpm = 121.0;
+    tempo.update (&playHead, 256);
+    CHECK (tempo.getSamplesForNoteLength (6) < length);
+}
+
+TEST_CASE ("A small tempo change glides long synced delays all the way", "[tempo]")
+{
+    // A whole note at 192 kHz is far beyond 2^18 samples, where a float
+    // can't take a step of 0.01 samples any more.
+    const double sampleRate = 192000.0;
+    const int blockSize = 512;
+    PluginProcessor plugin;
+    TestPlayHead playHead;
+    playHead.playing = false;  // so the reported tempo is used
+    plugin.setPlayHead (&playHead);
+    setParameter (plugin, tempoSyncParamID, 1.0f);
+    setParameter (plugin, delayNoteParamID, 15.0f);  // 1/1
+    setParameter (plugin, feedbackParamID, 0.0f);
+    setParameter (plugin, mixParamID, 100.0f);
+    plugin.prepareToPlay (sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer (2, blockSize);
+    juce::MidiBuffer midi;
+    auto run = [&] (int numBlocks) {
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            buffer.clear();
+            plugin.processBlock (buffer, midi);
+        }
+    };
+    run (10);
+
+    // 1% faster is well within the glide, which takes about 1.7 seconds
+    playHead.bpm = 121.0;
+    run (int (2.0 * sampleRate) / blockSize);
+
+    // the echo of an impulse now comes at the new length
+    const double expected = 4.0 * 60.0 / 121.0 * sampleRate;
+    int peakIndex = 0;
+    float peak = 0.0f;
+    for (int block = 0; block * blockSize < int (expected) + 2 * blockSize; ++block)
+    {
+        buffer.clear();
+        if (block == 0)
+        {
+            buffer.setSample (0, 0, 0.5f);
+            buffer.setSample (1, 0, 0.5f);
+        }
+        plugin.processBlock (buffer, midi);
+        for (int sample = 0; sample < blockSize; ++sample)
+        {
+            float value = std::abs (buffer.getSample (0, sample));
+            if (block * blockSize + sample > blockSize && value > peak)
+            {
+                peak = value;
+                peakIndex = block * blockSize + sample;
+            }
+        }
+    }
+    INFO ("echo at " << peakIndex << ", expected " << expected);
+    CHECK (peak > 0.1f);
+    CHECK (std::abs (peakIndex - expected) <= 1.0);
+}
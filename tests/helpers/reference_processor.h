@@ -0,0 +1,269 @@
+#pragma once
+#include <PluginProcessor.h>
+#include <DSP.h>
+#include <vector>
+
+/* A scalar model of PluginProcessor at the full sample rate, written to be
+ * easy to check rather than fast. It has none of the processor's
+ * optimisations:
+ * - no block reads out of the ring
+ * - no fused SIMD filter (it uses juce::dsp::StateVariableTPTFilter)
+ * - no reduced-precision storage
+ * - no kernel dispatch
+ * - no SIMD saturation (it shapes each channel on its own)
+ * It reads the same parameters, so a conformance test can drive both with
+ * the same automation and compare their output.
+ *
+ * The low rate feedback path is not modelled, and neither is the output
+ * guard. Keep the delay time within what prepare() allocates, so that the
+ * processor never has to wait for its background thread to grow the delay
+ * lines.
+ */
+class ReferenceProcessor
+{
+public:
+    explicit ReferenceProcessor (juce::AudioProcessorValueTreeState& apvts)
+        : gain (apvts.getRawParameterValue (gainParamID.getParamID())),
+          delayTime (apvts.getRawParameterValue (delayTimeParamID.getParamID())),
+          mix (apvts.getRawParameterValue (mixParamID.getParamID())),
+          feedback (apvts.getRawParameterValue (feedbackParamID.getParamID())),
+          stereo (apvts.getRawParameterValue (stereoParamID.getParamID())),
+          lowCut (apvts.getRawParameterValue (lowCutParamID.getParamID())),
+          highCut (apvts.getRawParameterValue (highCutParamID.getParamID())),
+          tempoSync (apvts.getRawParameterValue (tempoSyncParamID.getParamID())),
+          delayNote (apvts.getRawParameterValue (delayNoteParamID.getParamID())),
+          bypass (apvts.getRawParameterValue (bypassParamID.getParamID())),
+          drive (apvts.getRawParameterValue (driveParamID.getParamID()))
+    {
+    }
+
+    void prepare (double newSampleRate, int maxBlockSize)
+    {
+        sampleRate = float (newSampleRate);
+
+        for (auto* smoother : { &gainSmoother, &mixSmoother, &feedbackSmoother, &stereoSmoother, &lowCutSmoother, &highCutSmoother, &driveSmoother })
+            smoother->reset (newSampleRate, 0.02);
+        gainSmoother.setCurrentAndTargetValue (juce::Decibels::decibelsToGain (gain->load()));
+        mixSmoother.setCurrentAndTargetValue (mix->load() * 0.01f);
+        feedbackSmoother.setCurrentAndTargetValue (feedback->load() * 0.01f);
+        stereoSmoother.setCurrentAndTargetValue (stereo->load() * 0.01f);
+        lowCutSmoother.setCurrentAndTargetValue (lowCut->load());
+        highCutSmoother.setCurrentAndTargetValue (highCut->load());
+        driveSmoother.setCurrentAndTargetValue (drive->load() * 0.01f);
+
+        // the same amount of history as the processor allocates up front
+        float time = tempoSync->load() > 0.5f ? syncedTime() : delayTime->load();
+        float allocatedTime = std::clamp (time * 2.0f, 500.0f, Parameters::maxDelayTime);
+        maxDelayInSamples = int (std::ceil (allocatedTime / 1000.0 * newSampleRate));
+        historyL.assign (size_t (maxDelayInSamples + 2), 0.0f);
+        historyR.assign (size_t (maxDelayInSamples + 2), 0.0f);
+        writeIndex = 0;
+
+        for (auto* filter : { &lowCutFilter, &highCutFilter })
+        {
+            filter->prepare ({ newSampleRate, juce::uint32 (maxBlockSize), 2 });
+            filter->reset();
+        }
+        lowCutFilter.setType (juce::dsp::StateVariableTPTFilterType::highpass);
+        highCutFilter.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
+        lastLowCut = lastHighCut = -1.0f;
+
+        feedbackL = feedbackR = 0.0f;
+        saturatorL = saturatorR = 0.0f;
+        delayInSamples = targetDelay = 0.0f;
+        fade = fadeTarget = 1.0f;
+        fadeCoeff = 1.0f - std::exp (-1.0f / (0.05f * sampleRate));
+        wait = 0.0f;
+        waitInc = 1.0f / (0.3f * sampleRate);
+    }
+
+    // Processes the first channel only for a mono layout, otherwise two.
+    void process (juce::AudioBuffer<float>& buffer, bool isStereo)
+    {
+        gainSmoother.setTargetValue (juce::Decibels::decibelsToGain (gain->load()));
+        mixSmoother.setTargetValue (mix->load() * 0.01f);
+        feedbackSmoother.setTargetValue (feedback->load() * 0.01f);
+        stereoSmoother.setTargetValue (stereo->load() * 0.01f);
+        lowCutSmoother.setTargetValue (lowCut->load());
+        highCutSmoother.setTargetValue (highCut->load());
+        driveSmoother.setTargetValue (drive->load() * 0.01f);
+        float time = tempoSync->load() > 0.5f ? std::min (syncedTime(), Parameters::maxDelayTime) : delayTime->load();
+        bool bypassed = bypass->load() > 0.5f;
+
+        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        {
+            float gainNow = gainSmoother.getNextValue();
+            float mixNow = mixSmoother.getNextValue();
+            float feedbackNow = feedbackSmoother.getNextValue();
+            float driveNow = driveSmoother.getNextValue();
+            float panL, panR;
+            panningEqualPower (stereoSmoother.getNextValue(), panL, panR);
+            setCutoffs (lowCutSmoother.getNextValue(), highCutSmoother.getNextValue());
+
+            // duck on a change of delay time: fade out, wait, jump, fade in
+            float newTargetDelay = time / 1000.0f * sampleRate;
+            if (newTargetDelay != targetDelay)
+            {
+                targetDelay = newTargetDelay;
+                if (delayInSamples == 0.0f)
+                    delayInSamples = std::min (targetDelay, float (maxDelayInSamples));
+                if (delayInSamples != targetDelay)
+                {
+                    wait = waitInc;
+                    fadeTarget = 0.0f;
+                }
+            }
+            fade += (fadeTarget - fade) * fadeCoeff;
+
+            float dryL = buffer.getSample (0, sample);
+            float dryR = isStereo ? buffer.getSample (1, sample) : dryL;
+            float wetL, wetR = 0.0f;
+            if (isStereo)
+            {
+                float mono = (dryL + dryR) * 0.5f;
+                write (mono * panL + feedbackR, mono * panR + feedbackL);
+                wetL = read (historyL, delayInSamples) * fade;
+                wetR = read (historyR, delayInSamples) * fade;
+                feedbackL = saturate (highCutFilter.processSample (0, lowCutFilter.processSample (0, wetL * feedbackNow)), driveNow, saturatorL);
+                feedbackR = saturate (highCutFilter.processSample (1, lowCutFilter.processSample (1, wetR * feedbackNow)), driveNow, saturatorR);
+            }
+            else
+            {
+                write (dryL + feedbackL, 0.0f);
+                wetL = read (historyL, delayInSamples) * fade;
+                feedbackL = saturate (highCutFilter.processSample (0, lowCutFilter.processSample (0, wetL * feedbackNow)), driveNow, saturatorL);
+            }
+
+            if (wait > 0.0f)
+            {
+                wait += waitInc;
+                if (wait >= 1.0f)
+                {
+                    delayInSamples = targetDelay;
+                    wait = 0.0f;
+                    fadeTarget = 1.0f;
+                }
+            }
+
+            buffer.setSample (0, sample, bypassed ? dryL : (dryL + wetL * mixNow) * gainNow);
+            if (isStereo)
+                buffer.setSample (1, sample, bypassed ? dryR : (dryR + wetR * mixNow) * gainNow);
+        }
+    }
+
+private:
+    float syncedTime() const
+    {
+        // no playhead in the tests, so always the default tempo
+        Tempo tempo;
+        tempo.reset();
+        return float (tempo.getMillisecondsForNoteLength (int (delayNote->load())));
+    }
+
+    void setCutoffs (float newLowCut, float newHighCut)
+    {
+        float maxCutoff = 0.45f * sampleRate;
+        if (newLowCut != lastLowCut)
+        {
+            lowCutFilter.setCutoffFrequency (std::min (newLowCut, maxCutoff));
+            lastLowCut = newLowCut;
+        }
+        if (newHighCut != lastHighCut)
+        {
+            highCutFilter.setCutoffFrequency (std::min (newHighCut, maxCutoff));
+            lastHighCut = newHighCut;
+        }
+    }
+
+    // The feedback saturation: the mean of f(x) = x - 4x^3/27, clipped at
+    // 1.5, between the previous input and this one, driven and mixed in
+    // with the drive. Off at no drive. The same sums as BasicSaturator, one
+    // channel at a time.
+    static float saturate (float dry, float driveNow, float& previous)
+    {
+        if (driveNow <= 0.0f)
+            return dry;
+        float inputGain = 1.0f + 15.0f * driveNow;
+        return curveMean (dry * inputGain, previous) * (driveNow / inputGain) + dry * (1.0f - driveNow);
+    }
+
+    static float curveMean (float x, float& previous)
+    {
+        float clipped = std::clamp (x, -1.5f, 1.5f);
+        float clippedPrevious = std::clamp (previous, -1.5f, 1.5f);
+        float excess = std::abs (x) - std::abs (clipped);
+        float excessPrevious = std::abs (previous) - std::abs (clippedPrevious);
+
+        float sum = clipped + clippedPrevious;
+        float cubicMean = sum * 0.5f - sum * (clipped * clipped + clippedPrevious * clippedPrevious) * (1.0f / 27.0f);
+        float difference = cubicMean * (clipped - clippedPrevious) + excess - excessPrevious;
+        float step = x - previous;
+        previous = x;
+        if (step == 0.0f)
+            return clipped - clipped * clipped * clipped * (4.0f / 27.0f);
+        return difference / step;
+    }
+
+    void write (float left, float right)
+    {
+        writeIndex = (writeIndex + 1) % int (historyL.size());
+        historyL[size_t (writeIndex)] = left;
+        historyR[size_t (writeIndex)] = right;
+    }
+
+    // The history starts out zeroed, so anything not written yet reads as
+    // silence. The interpolation is the same cubic Hermite as
+    // DelayLine::read, in the same order of operations, so the float paths
+    // agree to the last bit when nothing else differs.
+    float read (const std::vector<float>& history, float delay) const
+    {
+        auto at = [&] (int samplesAgo) {
+            int size = int (history.size());
+            return history[size_t (((writeIndex - samplesAgo) % size + size) % size)];
+        };
+        int integerDelay = int (delay);
+        float sampleA = at (integerDelay - 1);
+        float sampleB = at (integerDelay);
+        float sampleC = at (integerDelay + 1);
+        float sampleD = at (integerDelay + 2);
+
+        float fraction = delay - float (integerDelay);
+        float slope0 = (sampleC - sampleA) * 0.5f;
+        float slope1 = (sampleD - sampleB) * 0.5f;
+        float v = sampleB - sampleC;
+        float w = slope0 + v;
+        float a = w + v + slope1;
+        float b = w + a;
+        float stage1 = a * fraction - b;
+        float stage2 = stage1 * fraction + slope0;
+        return stage2 * fraction + sampleB;
+    }
+
+    std::atomic<float>* gain;
+    std::atomic<float>* delayTime;
+    std::atomic<float>* mix;
+    std::atomic<float>* feedback;
+    std::atomic<float>* stereo;
+    std::atomic<float>* lowCut;
+    std::atomic<float>* highCut;
+    std::atomic<float>* tempoSync;
+    std::atomic<float>* delayNote;
+    std::atomic<float>* bypass;
+    std::atomic<float>* drive;
+
+    float sampleRate = 44100.0f;
+    juce::LinearSmoothedValue<float> gainSmoother, mixSmoother, feedbackSmoother, stereoSmoother, lowCutSmoother, highCutSmoother, driveSmoother;
+
+    std::vector<float> historyL, historyR;
+    int writeIndex = 0;
+    int maxDelayInSamples = 0;
+
+    juce::dsp::StateVariableTPTFilter<float> lowCutFilter, highCutFilter;
+    float lastLowCut = -1.0f, lastHighCut = -1.0f;
+    float feedbackL = 0.0f, feedbackR = 0.0f;
+    float saturatorL = 0.0f, saturatorR = 0.0f;  // the previous inputs
+
+    float delayInSamples = 0.0f, targetDelay = 0.0f;
+    float fade = 1.0f, fadeTarget = 1.0f, fadeCoeff = 0.0f;
+    float wait = 0.0f, waitInc = 0.0f;
+};